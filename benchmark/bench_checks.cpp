@@ -0,0 +1,225 @@
+/*
+ * bench_checks.cpp
+ *
+ *  Created on:  2026-10-18
+ */
+
+/*
+ * Micro benchmarks of the checks which are called for most objects.
+ *
+ * The inputs are generated with a fixed seed. Tag values follow distributions similar to
+ * those found in OSM data (most values are valid, a small share is broken).
+ */
+
+#include <cmath>
+#include <cstring>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <gdalcpp.hpp>
+#include <osmium/builder/osm_object_builder.hpp>
+#include <osmium/memory/buffer.hpp>
+#include <osmium/osm/way.hpp>
+
+#include "benchmark_util.hpp"
+#include "geometry_view_handler.hpp"
+#include "highway_view_handler.hpp"
+#include "tagging_view_handler.hpp"
+
+using tag_vector = std::vector<std::pair<std::string, std::string>>;
+
+static constexpr size_t INPUT_COUNT = 10000;
+
+static void add_way(osmium::memory::Buffer& buffer, const osmium::object_id_type id, const tag_vector& tags,
+        const std::vector<osmium::Location>& locations = {}) {
+    {
+        osmium::builder::WayBuilder builder{buffer};
+        builder.set_id(id);
+        {
+            osmium::builder::TagListBuilder tl_builder{builder};
+            for (const auto& tag : tags) {
+                tl_builder.add_tag(tag.first, tag.second);
+            }
+        }
+        osmium::builder::WayNodeListBuilder wnl_builder{builder};
+        osmium::object_id_type node_id = id * 100;
+        for (const osmium::Location& location : locations) {
+            wnl_builder.add_node_ref(osmium::NodeRef{node_id++, location});
+        }
+    }
+    buffer.commit();
+}
+
+static std::vector<const osmium::Way*> ways_of(const osmium::memory::Buffer& buffer) {
+    std::vector<const osmium::Way*> ways;
+    for (const osmium::Way& way : buffer.select<osmium::Way>()) {
+        ways.push_back(&way);
+    }
+    return ways;
+}
+
+template <typename TGenerator>
+static std::vector<std::string> sample(WeightedChoice<std::string>& choice, TGenerator& generator) {
+    std::vector<std::string> values;
+    for (size_t i = 0; i < INPUT_COUNT; ++i) {
+        values.push_back(choice(generator));
+    }
+    return values;
+}
+
+/**
+ * Build tags of a highway way.
+ */
+template <typename TGenerator>
+static tag_vector highway_tags(TGenerator& generator) {
+    static WeightedChoice<std::string> highway {{{"residential", 30}, {"service", 25}, {"footway", 12},
+        {"track", 10}, {"unclassified", 6}, {"tertiary", 5}, {"path", 5}, {"secondary", 3},
+        {"primary", 2}, {"cycleway", 1}, {"trunk", 0.5}, {"motorway", 0.5}}};
+    static WeightedChoice<std::string> name {{{"Hauptstraße", 1}, {"Main Street", 1}, {"Rue de la Paix", 1},
+        {"улица Ленина", 1}, {"fixme", 0.05}, {"unknown", 0.05}}};
+    static WeightedChoice<std::string> maxspeed {{{"50", 30}, {"30", 20}, {"100", 10}, {"70", 8},
+        {"30 mph", 6}, {"DE:urban", 4}, {"RU:urban", 1}, {"none", 1}, {"walk", 1}, {"signals", 0.5},
+        {"50;30", 0.3}, {"50 km/h", 0.3}}};
+    std::uniform_real_distribution<double> chance {0.0, 1.0};
+    tag_vector tags {{"highway", highway(generator)}};
+    if (chance(generator) < 0.4) {
+        tags.emplace_back("name", name(generator));
+    }
+    if (chance(generator) < 0.2) {
+        tags.emplace_back("maxspeed", maxspeed(generator));
+    }
+    if (chance(generator) < 0.1) {
+        tags.emplace_back("lanes", "2");
+    }
+    if (chance(generator) < 0.15) {
+        tags.emplace_back("surface", "asphalt");
+    }
+    if (chance(generator) < 0.1) {
+        tags.emplace_back("oneway", "yes");
+    }
+    return tags;
+}
+
+/**
+ * Build tags of an arbitrary object.
+ */
+template <typename TGenerator>
+static tag_vector object_tags(TGenerator& generator) {
+    static WeightedChoice<tag_vector> tags {{
+        {{{"building", "yes"}}, 30},
+        {{{"building", "house"}, {"addr:street", "Hauptstraße"}, {"addr:housenumber", "12"}}, 15},
+        {{{"highway", "residential"}, {"name", "Main Street"}}, 15},
+        {{{"natural", "tree"}}, 8},
+        {{{"addr:street", "Rue de la Paix"}, {"addr:housenumber", "4"}}, 5},
+        {{{"amenity", "bench"}, {"backrest", "yes"}}, 4},
+        {{{"landuse", "farmland"}}, 4},
+        {{{"power", "tower"}, {"ref", "12"}}, 4},
+        {{{"barrier", "fence"}}, 3},
+        {{{"source", "survey"}}, 1},
+        {{{"note", "check this"}, {"fixme", "position"}}, 0.5},
+        {{{"name", "Some name"}}, 0.5}
+    }};
+    return tags(generator);
+}
+
+/**
+ * Build a random walk. Some of them intersect themselves.
+ */
+template <typename TGenerator>
+static std::vector<osmium::Location> random_walk(TGenerator& generator) {
+    static WeightedChoice<size_t> node_count {{{2, 20}, {3, 15}, {4, 12}, {5, 10}, {8, 15}, {15, 12},
+        {30, 8}, {80, 5}, {250, 2}, {1000, 1}}};
+    std::uniform_real_distribution<double> start {-10.0, 10.0};
+    std::normal_distribution<double> turn {0.0, 0.6};
+    std::vector<osmium::Location> locations;
+    double x = start(generator);
+    double y = start(generator);
+    double direction = 0.0;
+    const size_t count = node_count(generator);
+    for (size_t i = 0; i < count; ++i) {
+        locations.emplace_back(x, y);
+        direction += turn(generator);
+        x += 0.0001 * std::cos(direction);
+        y += 0.0001 * std::sin(direction);
+    }
+    return locations;
+}
+
+int main() {
+    std::mt19937 generator {42};
+
+    Options options;
+    gdalcpp::Dataset dataset {"Memory", "benchmark", gdalcpp::SRS{options.srs}};
+    auto create_layer = [&dataset](const char* layer_name, OGRwkbGeometryType type) {
+        return std::unique_ptr<gdalcpp::Layer>{new gdalcpp::Layer{dataset, layer_name, type}};
+    };
+    HighwayViewHandler highway_handler {options, create_layer};
+    GeometryViewHandler geometry_handler {options, create_layer};
+
+    WeightedChoice<std::string> turn_lanes {{{"left|through|right", 20}, {"through|through|right", 15},
+        {"left;through|through", 12}, {"left|left;through|through;right|right", 8}, {"none|through", 8},
+        {"through|slight_right", 5}, {"|through", 4}, {"reverse|left|through", 2},
+        {"merge_to_left|through", 2}, {"left|throught", 0.5}, {"left||right|", 0.5}}};
+    WeightedChoice<std::string> lengths {{{"2.5", 20}, {"3", 20}, {"3.5 m", 10}, {"4.2", 10},
+        {"12'6\"", 5}, {"2.3m", 2}, {"default", 1}, {"below_default", 1}, {"3,8", 1}}};
+    WeightedChoice<std::string> weights {{{"3.5", 20}, {"7.5", 20}, {"12", 10}, {"3.5 t", 15},
+        {"40 t", 5}, {"7.5t", 3}, {"5 st", 1}, {"6000 lbs", 1}, {"none", 1}, {"2,8", 1}}};
+    WeightedChoice<std::string> keys {{{"name", 30}, {"name:en", 15}, {"name:de", 10}, {"old_name", 5},
+        {"alt_name", 5}, {"official_name", 3}, {"name:etymology:wikidata", 2}, {"addr:street", 15},
+        {"building", 15}}};
+    WeightedChoice<std::string> texts {{{"Main Street", 30}, {"Hauptstraße", 20}, {"улица Ленина", 10},
+        {"東京駅", 5}, {"شارع الملك فهد", 3},
+        {"A rather long description of an object which was written by a very enthusiastic mapper", 1}}};
+
+    const std::vector<std::string> turn_values = sample(turn_lanes, generator);
+    const std::vector<std::string> length_values = sample(lengths, generator);
+    const std::vector<std::string> weight_values = sample(weights, generator);
+    const std::vector<std::string> key_values = sample(keys, generator);
+    const std::vector<std::string> text_values = sample(texts, generator);
+
+    osmium::memory::Buffer highway_buffer {1024 * 1024, osmium::memory::Buffer::auto_grow::yes};
+    osmium::memory::Buffer object_buffer {1024 * 1024, osmium::memory::Buffer::auto_grow::yes};
+    osmium::memory::Buffer geometry_buffer {1024 * 1024, osmium::memory::Buffer::auto_grow::yes};
+    for (size_t i = 0; i < INPUT_COUNT; ++i) {
+        const osmium::object_id_type id = static_cast<osmium::object_id_type>(i) + 1;
+        add_way(highway_buffer, id, highway_tags(generator));
+        add_way(object_buffer, id, object_tags(generator));
+        add_way(geometry_buffer, id, {{"highway", "service"}}, random_walk(generator));
+    }
+    const std::vector<const osmium::Way*> highways = ways_of(highway_buffer);
+    const std::vector<const osmium::Way*> objects = ways_of(object_buffer);
+    const std::vector<const osmium::Way*> geometries = ways_of(geometry_buffer);
+
+    run_benchmark("HighwayViewHandler::check_valid_turns", turn_values, [](const std::string& v) {
+        return HighwayViewHandler::check_valid_turns(v.c_str());
+    });
+    run_benchmark("HighwayViewHandler::check_length_value", length_values, [](const std::string& v) {
+        return HighwayViewHandler::check_length_value(v.c_str());
+    });
+    run_benchmark("HighwayViewHandler::check_maxweight", weight_values, [](const std::string& v) {
+        return HighwayViewHandler::check_maxweight(v.c_str());
+    });
+    run_benchmark("HighwayViewHandler::maxspeed_ok", highways, [](const osmium::Way* way) {
+        return HighwayViewHandler::maxspeed_ok(way->tags());
+    });
+    run_benchmark("AbstractViewHandler::tags_string", highways, [&highway_handler](const osmium::Way* way) {
+        return strlen(highway_handler.tags_string(way->tags(), "highway"));
+    });
+    run_benchmark("TaggingViewHandler::has_feature_key", objects, [](const osmium::Way* way) {
+        return TaggingViewHandler::has_feature_key(way->tags(), osmium::item_type::way);
+    });
+    run_benchmark("TaggingViewHandler::is_a_x_key_key", key_values, [](const std::string& v) {
+        return TaggingViewHandler::is_a_x_key_key(v.c_str(), "name");
+    });
+    run_benchmark("TaggingViewHandler::char_length_utf8", text_values, [](const std::string& v) {
+        return TaggingViewHandler::char_length_utf8(v.c_str());
+    });
+    run_benchmark("GeometryViewHandler::check_self_intersection", geometries,
+            [&geometry_handler](const osmium::Way* way) {
+        geometry_handler.check_self_intersection(*way);
+        return 0;
+    });
+}
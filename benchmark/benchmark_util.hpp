@@ -0,0 +1,114 @@
+/*
+ * benchmark_util.hpp
+ *
+ *  Created on:  2026-10-18
+ */
+
+#ifndef BENCHMARK_BENCHMARK_UTIL_HPP_
+#define BENCHMARK_BENCHMARK_UTIL_HPP_
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+// The distributions of the standard library are implemented differently by each library.
+// The following functions only use the output of the generator (e.g. std::mt19937_64), which
+// is specified by the standard. Their results are the same on all platforms.
+
+/**
+ * Get 64 random bits from a generator producing 32 or 64 bits per call.
+ */
+template <typename TGenerator>
+uint64_t random_bits(TGenerator& generator) {
+    static_assert(TGenerator::min() == 0 && (TGenerator::max() == UINT32_MAX || TGenerator::max() == UINT64_MAX),
+            "32-bit or 64-bit generator required");
+    if constexpr (TGenerator::max() == UINT64_MAX) {
+        return generator();
+    } else {
+        const uint64_t high = generator();
+        return (high << 32) | generator();
+    }
+}
+
+/**
+ * Get a random number in [0, 1).
+ */
+template <typename TGenerator>
+double random_fraction(TGenerator& generator) {
+    // A double has 53 significant bits.
+    return static_cast<double>(random_bits(generator) >> 11) * (1.0 / 9007199254740992.0);
+}
+
+/**
+ * Get a random integer in [min, max].
+ */
+template <typename TGenerator>
+uint64_t random_integer(TGenerator& generator, const uint64_t min, const uint64_t max) {
+    return min + random_bits(generator) % (max - min + 1);
+}
+
+/**
+ * Pick values at random with fixed weights. The random generator is seeded by the caller
+ * to get reproducible inputs.
+ */
+template <typename T>
+class WeightedChoice {
+    std::vector<T> m_values;
+
+    /// sum of the weights of all values up to and including the value with the same index
+    std::vector<double> m_cumulative_weights;
+
+public:
+    explicit WeightedChoice(const std::vector<std::pair<T, double>>& values) :
+        m_values(),
+        m_cumulative_weights() {
+        double sum = 0.0;
+        for (const auto& v : values) {
+            m_values.push_back(v.first);
+            sum += v.second;
+            m_cumulative_weights.push_back(sum);
+        }
+    }
+
+    template <typename TGenerator>
+    const T& operator()(TGenerator& generator) {
+        const double weight = random_fraction(generator) * m_cumulative_weights.back();
+        const auto it = std::upper_bound(m_cumulative_weights.begin(), m_cumulative_weights.end(), weight);
+        return m_values[std::min<size_t>(it - m_cumulative_weights.begin(), m_values.size() - 1)];
+    }
+};
+
+/**
+ * Call a function for all inputs repeatedly until at least min_seconds elapsed and print
+ * the average time per call.
+ *
+ * \param name name of the benchmark
+ * \param inputs inputs passed to the function one after another
+ * \param func function to be measured, its return value is consumed to prevent the compiler
+ *        from optimising the call away
+ */
+template <typename TInput, typename TFunc>
+void run_benchmark(const char* name, const std::vector<TInput>& inputs, TFunc&& func,
+        const double min_seconds = 0.5) {
+    using clock = std::chrono::steady_clock;
+    volatile size_t sink = 0;
+    size_t calls = 0;
+    const clock::time_point start = clock::now();
+    clock::duration elapsed;
+    do {
+        for (const TInput& input : inputs) {
+            sink = sink + static_cast<size_t>(func(input));
+        }
+        calls += inputs.size();
+        elapsed = clock::now() - start;
+    } while (std::chrono::duration<double>(elapsed).count() < min_seconds);
+    const double ns_per_call = std::chrono::duration<double, std::nano>(elapsed).count() / calls;
+    std::printf("%-45s %12.1f ns/call %14zu calls\n", name, ns_per_call, calls);
+}
+
+#endif /* BENCHMARK_BENCHMARK_UTIL_HPP_ */
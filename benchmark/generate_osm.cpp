@@ -0,0 +1,497 @@
+/*
+ * generate_osm.cpp
+ *
+ *  Created on:  2026-10-18
+ */
+
+/*
+ * Generate a synthetic OSM file for end-to-end benchmarks.
+ *
+ * The data is a road grid with places, points of interest, hiking paths, turn restrictions
+ * and route relations. A known share of the objects contains errors detected by the views
+ * (self-intersecting ways, bad turn:lanes, broken via chains, misspelled keys etc.).
+ *
+ * The output only depends on the seed and the size. It does not use the distributions of the
+ * C++ standard library (see random_fraction), therefore it is the same on all platforms.
+ */
+
+#include <getopt.h>
+#include <stdlib.h>
+#include <algorithm>
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <osmium/builder/osm_object_builder.hpp>
+#include <osmium/io/pbf_output.hpp>
+#include <osmium/io/writer.hpp>
+#include <osmium/memory/buffer.hpp>
+#include <osmium/osm/location.hpp>
+#include <osmium/osm/timestamp.hpp>
+
+#include "benchmark_util.hpp"
+
+using tag_vector = std::vector<std::pair<std::string, std::string>>;
+
+struct Member {
+    osmium::item_type type;
+    osmium::object_id_type ref;
+    const char* role;
+};
+
+/**
+ * Road segment on a row or column of the grid
+ */
+struct Segment {
+    osmium::object_id_type way_id;
+    size_t first;
+    size_t last;
+};
+
+class Generator {
+    static constexpr size_t BUFFER_SIZE = 10 * 1024 * 1024;
+    static constexpr double SPACING = 0.001;
+
+    std::mt19937_64 m_generator;
+
+    /// number of intersections per row and column
+    size_t m_size;
+
+    osmium::io::Writer& m_writer;
+
+    osmium::memory::Buffer m_buffer;
+
+    osmium::object_id_type m_next_node_id = 1;
+    osmium::object_id_type m_next_way_id = 1;
+    osmium::object_id_type m_next_relation_id = 1;
+
+    /// road segments of each row and each column of the grid
+    std::vector<std::vector<Segment>> m_rows;
+    std::vector<std::vector<Segment>> m_columns;
+
+    const osmium::Timestamp m_timestamp {"2020-01-01T00:00:00Z"};
+
+    bool chance(const double probability) {
+        return random_fraction(m_generator) < probability;
+    }
+
+    /**
+     * Get the index of a random row or column of grid cells.
+     */
+    size_t random_cell() {
+        return random_integer(m_generator, 0, m_size - 2);
+    }
+
+    osmium::object_id_type intersection_id(const size_t row, const size_t column) const {
+        return static_cast<osmium::object_id_type>(row * m_size + column) + 1;
+    }
+
+    osmium::Location intersection_location(const size_t row, const size_t column) const {
+        return osmium::Location{8.0 + column * SPACING, 48.0 + row * SPACING};
+    }
+
+    osmium::Location random_location() {
+        // The elements of a braced initializer list are evaluated from left to right.
+        return osmium::Location{8.0 + random_fraction(m_generator) * m_size * SPACING,
+            48.0 + random_fraction(m_generator) * m_size * SPACING};
+    }
+
+    void flush_if_full() {
+        if (m_buffer.committed() > BUFFER_SIZE - 1024 * 1024) {
+            m_writer(std::move(m_buffer));
+            m_buffer = osmium::memory::Buffer{BUFFER_SIZE, osmium::memory::Buffer::auto_grow::yes};
+        }
+    }
+
+    template <typename TBuilder>
+    void set_attributes(TBuilder& builder, const osmium::object_id_type id) {
+        builder.set_id(id);
+        builder.set_version(1);
+        builder.set_changeset(1);
+        builder.set_uid(1);
+        builder.set_timestamp(m_timestamp);
+        builder.set_user("generator");
+    }
+
+    static void add_tags(osmium::builder::Builder& parent, const tag_vector& tags) {
+        osmium::builder::TagListBuilder tl_builder{parent};
+        for (const auto& tag : tags) {
+            tl_builder.add_tag(tag.first, tag.second);
+        }
+    }
+
+    void add_node(const osmium::object_id_type id, const osmium::Location location, const tag_vector& tags = {}) {
+        {
+            osmium::builder::NodeBuilder builder{m_buffer};
+            set_attributes(builder, id);
+            builder.set_location(location);
+            add_tags(builder, tags);
+        }
+        m_buffer.commit();
+        flush_if_full();
+    }
+
+    osmium::object_id_type add_way(const std::vector<osmium::object_id_type>& nodes, const tag_vector& tags) {
+        const osmium::object_id_type id = m_next_way_id++;
+        {
+            osmium::builder::WayBuilder builder{m_buffer};
+            set_attributes(builder, id);
+            add_tags(builder, tags);
+            osmium::builder::WayNodeListBuilder wnl_builder{builder};
+            for (const osmium::object_id_type ref : nodes) {
+                wnl_builder.add_node_ref(osmium::NodeRef{ref});
+            }
+        }
+        m_buffer.commit();
+        flush_if_full();
+        return id;
+    }
+
+    void add_relation(const std::vector<Member>& members, const tag_vector& tags) {
+        {
+            osmium::builder::RelationBuilder builder{m_buffer};
+            set_attributes(builder, m_next_relation_id++);
+            add_tags(builder, tags);
+            osmium::builder::RelationMemberListBuilder rml_builder{builder};
+            for (const Member& member : members) {
+                rml_builder.add_member(member.type, member.ref, member.role);
+            }
+        }
+        m_buffer.commit();
+        flush_if_full();
+    }
+
+    /**
+     * Return tags of a road. Every tenth row or column is a major road.
+     */
+    tag_vector road_tags(const size_t line) {
+        static WeightedChoice<std::string> minor {{{"residential", 50}, {"service", 20},
+            {"unclassified", 15}, {"track", 10}, {"living_street", 5}}};
+        static WeightedChoice<std::string> major {{{"tertiary", 50}, {"secondary", 30}, {"primary", 15},
+            {"trunk", 5}}};
+        static WeightedChoice<std::string> names {{{"Hauptstraße", 1}, {"Main Street", 1},
+            {"Rue de la Paix", 1}, {"улица Ленина", 1}, {"Calle Mayor", 1}}};
+        static WeightedChoice<std::string> maxspeeds {{{"50", 40}, {"30", 25}, {"70", 10}, {"100", 5},
+            {"30 mph", 5}, {"DE:urban", 5}, {"50 kmh", 1}, {"fast", 0.5}}};
+        static WeightedChoice<std::string> turn_lanes {{{"left|through", 40}, {"through|right", 30},
+            {"left;through|through;right", 20}, {"left|through|through", 5}, {"left|throught", 5}}};
+        const bool major_road = line % 10 == 0;
+        tag_vector tags {{"highway", major_road ? major(m_generator) : minor(m_generator)}};
+        if (chance(major_road ? 0.98 : 0.6)) {
+            tags.emplace_back("name", names(m_generator));
+        } else if (chance(0.01)) {
+            tags.emplace_back("name", "fixme");
+        }
+        if (chance(major_road ? 0.5 : 0.15)) {
+            tags.emplace_back("maxspeed", maxspeeds(m_generator));
+        }
+        if (major_road && chance(0.3)) {
+            tags.emplace_back("lanes", "2");
+            if (chance(0.3)) {
+                // 5% of these have three lanes in turn:lanes or a typo
+                tags.emplace_back("turn:lanes", turn_lanes(m_generator));
+            }
+        }
+        if (chance(0.05)) {
+            tags.emplace_back("oneway", chance(0.95) ? "yes" : "1");
+        }
+        if (chance(0.02)) {
+            tags.emplace_back("maxheight", chance(0.9) ? "3.5" : "3,5m");
+        }
+        if (chance(0.01)) {
+            tags.emplace_back("abandoned:highway", "residential");
+        }
+        return tags;
+    }
+
+    tag_vector path_tags() {
+        static WeightedChoice<std::string> sac_scales {{{"hiking", 40}, {"mountain_hiking", 30},
+            {"demanding_mountain_hiking", 15}, {"alpine_hiking", 8}, {"T2", 4}, {"hiking;mountain_hiking", 3}}};
+        static WeightedChoice<std::string> highways {{{"path", 70}, {"footway", 20}, {"track", 8}, {"residential", 2}}};
+        tag_vector tags {{"highway", highways(m_generator)}};
+        if (chance(0.8)) {
+            tags.emplace_back("sac_scale", sac_scales(m_generator));
+        }
+        if (chance(0.3)) {
+            tags.emplace_back("surface", chance(0.5) ? "ground" : "rock");
+        }
+        return tags;
+    }
+
+    tag_vector poi_tags() {
+        static WeightedChoice<tag_vector> pois {{
+            {{{"amenity", "bench"}}, 20},
+            {{{"natural", "tree"}}, 20},
+            {{{"amenity", "restaurant"}, {"name", "Zur Post"}}, 10},
+            {{{"shop", "bakery"}, {"name", "Bäckerei"}, {"opening_hours", "Mo-Fr 06:00-18:00"}}, 10},
+            {{{"highway", "bus_stop"}, {"name", "Marktplatz"}}, 10},
+            {{{"highway", "traffic_signals"}}, 10},
+            {{{"barrier", "gate"}}, 5},
+            {{{"highway", "crossing"}, {"crossing", "uncontrolled"}}, 5},
+            {{{"amenity", "bench"}, {"fixme", "position"}}, 2},
+            {{{"nmae", "Typo"}, {"amenity", "cafe"}}, 2},
+            {{{"amenity", ""}}, 1},
+            {{{"highway", "bogus_value"}}, 1},
+            {{{"source", "survey"}}, 2},
+            {{{"note", "A rather long description of an object which was written by a very enthusiastic mapper "
+                "who wanted to tell everybody about everything they know about this particular bench"}}, 2}
+        }};
+        return pois(m_generator);
+    }
+
+    tag_vector place_tags() {
+        static WeightedChoice<std::string> places {{{"hamlet", 40}, {"village", 30}, {"suburb", 10},
+            {"town", 10}, {"city", 3}, {"locality", 5}, {"villlage", 2}}};
+        static WeightedChoice<std::string> names {{{"Neustadt", 1}, {"Springfield", 1}, {"Villeneuve", 1},
+            {"Новгород", 1}}};
+        tag_vector tags {{"place", places(m_generator)}};
+        if (chance(0.97)) {
+            tags.emplace_back("name", names(m_generator));
+        }
+        if (chance(0.5)) {
+            tags.emplace_back("population", chance(0.95) ? std::to_string(random_integer(m_generator, 50, 200000))
+                    : "ca. 500");
+        }
+        return tags;
+    }
+
+    void write_nodes(const size_t poi_count, const size_t place_count) {
+        for (size_t row = 0; row < m_size; ++row) {
+            for (size_t column = 0; column < m_size; ++column) {
+                add_node(intersection_id(row, column), intersection_location(row, column));
+            }
+        }
+        m_next_node_id = intersection_id(m_size - 1, m_size - 1) + 1;
+        for (size_t i = 0; i < place_count; ++i) {
+            const osmium::Location location = random_location();
+            add_node(m_next_node_id++, location, place_tags());
+        }
+        for (size_t i = 0; i < poi_count; ++i) {
+            const osmium::Location location = random_location();
+            add_node(m_next_node_id++, location, poi_tags());
+        }
+    }
+
+    /**
+     * Split a row or column into roads of random length.
+     *
+     * \param line index of the row or column
+     * \param horizontal true for rows
+     */
+    std::vector<Segment> write_roads(const size_t line, const bool horizontal) {
+        std::vector<Segment> segments;
+        size_t first = 0;
+        while (first + 1 < m_size) {
+            const size_t last = std::min<size_t>(first + random_integer(m_generator, 3, 30), m_size - 1);
+            std::vector<osmium::object_id_type> nodes;
+            for (size_t i = first; i <= last; ++i) {
+                nodes.push_back(horizontal ? intersection_id(line, i) : intersection_id(i, line));
+            }
+            segments.push_back(Segment{add_way(nodes, road_tags(line)), first, last});
+            first = last;
+        }
+        return segments;
+    }
+
+    /**
+     * Write a way crossing itself (like a bow tie) in the grid cell starting at row/column.
+     */
+    void write_self_intersecting_way(const size_t row, const size_t column) {
+        add_way({intersection_id(row, column), intersection_id(row + 1, column + 1),
+                intersection_id(row, column + 1), intersection_id(row + 1, column)},
+                {{"highway", "service"}});
+    }
+
+    /**
+     * Find the road containing the intersection at position index of a row or column.
+     */
+    static const Segment* find_segment(const std::vector<Segment>& segments, const size_t index) {
+        for (const Segment& segment : segments) {
+            if (segment.first <= index && index <= segment.last) {
+                return &segment;
+            }
+        }
+        return nullptr;
+    }
+
+    void write_restriction(const size_t row, const size_t column, const bool broken) {
+        static WeightedChoice<std::string> restrictions {{{"no_left_turn", 40}, {"no_u_turn", 20},
+            {"only_straight_on", 15}, {"no_right_turn", 15}, {"only_right_turn", 8}, {"no_left_trun", 2}}};
+        const Segment* from = find_segment(m_rows.at(row), column);
+        const Segment* to = find_segment(m_columns.at(column), row);
+        if (!from || !to) {
+            return;
+        }
+        std::vector<Member> members {{osmium::item_type::way, from->way_id, "from"}};
+        if (broken) {
+            // The via way does not connect the from and the to way.
+            const Segment* via = find_segment(m_rows.at((row + 5) % m_size), column);
+            if (!via) {
+                return;
+            }
+            members.push_back(Member{osmium::item_type::way, via->way_id, "via"});
+        } else {
+            members.push_back(Member{osmium::item_type::node, intersection_id(row, column), "via"});
+        }
+        members.push_back(Member{osmium::item_type::way, to->way_id, "to"});
+        add_relation(members, {{"type", "restriction"}, {"restriction", restrictions(m_generator)}});
+    }
+
+    void write_route(const size_t row) {
+        std::vector<Member> members;
+        for (const Segment& segment : m_rows.at(row)) {
+            members.push_back(Member{osmium::item_type::way, segment.way_id, ""});
+        }
+        tag_vector tags {{"type", "route"}, {"route", "bus"}, {"ref", std::to_string(row)}};
+        // Routes must not have a highway tag.
+        if (chance(0.1)) {
+            tags.emplace_back("highway", "primary");
+        }
+        add_relation(members, tags);
+    }
+
+public:
+    Generator(const uint64_t seed, const size_t size, osmium::io::Writer& writer) :
+        m_generator(seed),
+        m_size(size),
+        m_writer(writer),
+        m_buffer(BUFFER_SIZE, osmium::memory::Buffer::auto_grow::yes),
+        m_rows(),
+        m_columns() {
+    }
+
+    void run() {
+        const size_t cells = m_size * m_size;
+        write_nodes(cells / 20, std::max<size_t>(1, cells / 400));
+
+        for (size_t row = 0; row < m_size; ++row) {
+            m_rows.push_back(write_roads(row, true));
+        }
+        for (size_t column = 0; column < m_size; ++column) {
+            m_columns.push_back(write_roads(column, false));
+        }
+        // footpaths on the diagonals of some cells
+        // The order of evaluation of function arguments is unspecified. Random numbers are
+        // assigned to variables first.
+        for (size_t i = 0; i < cells / 50; ++i) {
+            const size_t row = random_cell();
+            const size_t column = random_cell();
+            add_way({intersection_id(row, column), intersection_id(row + 1, column + 1)}, path_tags());
+        }
+        for (size_t i = 0; i < cells / 1000 + 1; ++i) {
+            const size_t row = random_cell();
+            const size_t column = random_cell();
+            write_self_intersecting_way(row, column);
+        }
+
+        for (size_t i = 0; i < cells / 100 + 1; ++i) {
+            const size_t row = random_cell();
+            const size_t column = random_cell();
+            const bool broken = chance(0.05);
+            write_restriction(row, column, broken);
+        }
+        for (size_t row = 0; row < m_size; row += 10) {
+            write_route(row);
+        }
+        m_writer(std::move(m_buffer));
+    }
+};
+
+void print_help(char* arg0) {
+    std::cerr << "Usage: " << arg0 << " [OPTIONS] OUTPUT_FILE\n" \
+              << "Generate a synthetic OSM file for benchmarks.\n" \
+              << "Options:\n" \
+              << "  -h, --help           This help message.\n" \
+              << "  -s N, --seed=N       Seed of the random number generator (default: 1)\n" \
+              << "  -S SIZE, --size=SIZE Size of the road grid: city (200), region (1000),\n" \
+              << "                       country (4000) or the number of rows and columns\n" \
+              << "                       (default: city)\n";
+}
+
+/**
+ * Parse a non-negative decimal integer.
+ *
+ * \returns false if the argument is not a number or out of range
+ */
+bool parse_number(const char* argument, uint64_t& value) {
+    if (*argument < '0' || *argument > '9') {
+        return false;
+    }
+    char* end = nullptr;
+    errno = 0;
+    const unsigned long long result = strtoull(argument, &end, 10);
+    if (*end != '\0' || errno == ERANGE) {
+        return false;
+    }
+    value = result;
+    return true;
+}
+
+int main(int argc, char* argv[]) {
+    static struct option long_options[] = {
+        {"help",   no_argument, 0, 'h'},
+        {"seed", required_argument, 0, 's'},
+        {"size", required_argument, 0, 'S'},
+        {0, 0, 0, 0}
+    };
+    uint64_t seed = 1;
+    size_t size = 200;
+    while (true) {
+        int c = getopt_long(argc, argv, "hs:S:", long_options, 0);
+        if (c == -1) {
+            break;
+        }
+        switch (c) {
+            case 'h':
+                print_help(argv[0]);
+                exit(1);
+            case 's':
+                if (!parse_number(optarg, seed)) {
+                    std::cerr << "ERROR: --seed must be a non-negative integer\n";
+                    print_help(argv[0]);
+                    exit(1);
+                }
+                break;
+            case 'S':
+                if (!strcmp(optarg, "city")) {
+                    size = 200;
+                } else if (!strcmp(optarg, "region")) {
+                    size = 1000;
+                } else if (!strcmp(optarg, "country")) {
+                    size = 4000;
+                } else {
+                    uint64_t rows = 0;
+                    if (!parse_number(optarg, rows) || rows < 2) {
+                        std::cerr << "ERROR: --size must be city, region, country or an integer of at least 2\n";
+                        print_help(argv[0]);
+                        exit(1);
+                    }
+                    size = static_cast<size_t>(rows);
+                }
+                break;
+            default:
+                print_help(argv[0]);
+                exit(1);
+        }
+    }
+    if (argc - optind != 1 || size < 2) {
+        print_help(argv[0]);
+        exit(1);
+    }
+
+    osmium::io::Header header;
+    header.set("generator", "osmi_simple_views generate_osm");
+    header.set("timestamp", "2020-01-01T00:00:00Z");
+    // Nodes, ways and relations are written in this order with ascending IDs. This allows
+    // osmi_simple_views to read only the blocks containing relations in the relation pass.
+    header.set("sorting", "Type_then_ID");
+    osmium::io::Writer writer{osmium::io::File{argv[optind], "pbf"}, header, osmium::io::overwrite::allow};
+    Generator generator {seed, size, writer};
+    generator.run();
+    writer.close();
+}
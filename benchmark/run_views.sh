@@ -0,0 +1,35 @@
+#!/bin/bash
+#
+# Run every view on an OSM file (e.g. written by generate_osm) and report the
+# throughput of the main pass (nodes and ways) and the total run time.
+#
+# Usage: run_views.sh OSMI_SIMPLE_VIEWS INPUT_FILE [OPTIONS...]
+#
+# Additional options are passed to osmi_simple_views.
+
+set -euo pipefail
+
+if [ $# -lt 2 ]; then
+    echo "Usage: $0 OSMI_SIMPLE_VIEWS INPUT_FILE [OPTIONS...]" >&2
+    exit 1
+fi
+
+PROGRAM=$1
+INPUT=$2
+shift 2
+
+WORKDIR=$(mktemp -d)
+trap 'rm -rf "$WORKDIR"' EXIT
+
+printf "%-20s %12s %18s\n" "view" "time [s]" "objects/s"
+for VIEW in tagging highways places geometry sac_scale turn_restrictions; do
+    mkdir "$WORKDIR/$VIEW"
+    START=$(date +%s.%N)
+    # Only the pass-level numbers of the statistics are used. With a single view --stats
+    # times whole buffers and does not change how the objects are passed to the handlers.
+    "$PROGRAM" -t "$VIEW" --stats="$WORKDIR/$VIEW.json" "$@" "$INPUT" "$WORKDIR/$VIEW"
+    END=$(date +%s.%N)
+    OBJECTS_PER_SECOND=$(grep '"name": "nodes and ways"' "$WORKDIR/$VIEW.json" \
+        | sed -e 's/.*"objects_per_second": \([0-9.e+]*\).*/\1/')
+    printf "%-20s %12.2f %18.0f\n" "$VIEW" "$(echo "$END - $START" | bc)" "$OBJECTS_PER_SECOND"
+done
@@ -24,44 +24,80 @@
 #include <locale>
 
 AbstractViewHandler::AbstractViewHandler(Options& options) :
-        OGROutputBase(options) {
+        OGROutputBase(options),
+        m_check_counters(options.check_counters) {
 }
 
 AbstractViewHandler::~AbstractViewHandler() {
 }
 
+bool AbstractViewHandler::supports_selection() const {
+    return false;
+}
+
+bool AbstractViewHandler::way_produces_output(const osmium::Way& way) {
+    if (!supports_selection()) {
+        return true;
+    }
+    m_selection_mode = true;
+    m_selected = false;
+    try {
+        this->way(way);
+    } catch (...) {
+        m_selection_mode = false;
+        throw;
+    }
+    m_selection_mode = false;
+    return m_selected;
+}
+
+bool AbstractViewHandler::limited_by_keys() const {
+    return false;
+}
+
+bool AbstractViewHandler::way_has_relevant_keys(const osmium::Way&) const {
+    return true;
+}
+
+key_mask_type AbstractViewHandler::node_key_interest() const {
+    return every_object;
+}
+
+key_mask_type AbstractViewHandler::way_key_interest() const {
+    return every_object;
+}
+
+bool AbstractViewHandler::supports_batches() const {
+    return false;
+}
+
+void AbstractViewHandler::way_batch(WayBatch& batch) {
+    batch.for_each([this](const osmium::Way& w, const size_t) {
+        this->way(w);
+    });
+}
+
 bool AbstractViewHandler::all_nodes_valid(const osmium::WayNodeList& wnl) {
     for (const osmium::NodeRef& nd_ref : wnl) {
         if (!nd_ref.location().valid()) {
-            m_options.verbose_output << "Invalid location for node " << nd_ref.ref() << "\n";
+            log_verbose(m_options.verbose_output, "Invalid location for node ", nd_ref.ref(), "\n");
             return false;
         }
         if (!coordinates_valid(nd_ref.location())) {
-            m_options.verbose_output << "Unprojectable coordinates for node " << nd_ref.ref() << '\n';
+            log_verbose(m_options.verbose_output, "Unprojectable coordinates for node ", nd_ref.ref(), '\n');
             return false;
         }
     }
     return true;
 }
 
-std::string AbstractViewHandler::tags_string(const osmium::TagList& tags, const char* not_include) {
-    std::string tag_str;
-    // only add tags to the tags string if their key and value are shorter than 50 characters
+const char* AbstractViewHandler::tags_string(const osmium::TagList& tags, const char* not_include) {
+    m_tags_builder.reset();
     for (const osmium::Tag& t : tags) {
         if (not_include && !strcmp(t.key(), not_include)) {
             continue;
         }
-        size_t add_length = strlen(t.key()) + strlen(t.value()) + 2;
-        if (add_length < 50 && tag_str.length() + add_length < MAX_FIELD_LENGTH) {
-            tag_str += t.key();
-            tag_str += '=';
-            tag_str += t.value();
-            tag_str += '|';
-        }
-    }
-    // remove last | from tag_str
-    if (!tag_str.empty()) {
-        tag_str.pop_back();
+        m_tags_builder.append(t.key(), t.value(), '|');
     }
-    return tag_str;
+    return m_tags_builder.finish();
 }
@@ -27,7 +27,12 @@
 #include <gdalcpp.hpp>
 #include <osmium/handler.hpp>
 #include <osmium/osm/way.hpp>
+#include "check_counters.hpp"
 #include "ogr_output_base.hpp"
+#include "tag_digest.hpp"
+#include "tag_string_builder.hpp"
+#include "verbose_log.hpp"
+#include "way_batch.hpp"
 
 class AbstractViewHandler : public osmium::handler::Handler, public OGROutputBase {
 
@@ -35,6 +40,59 @@ protected:
 
     static constexpr double UPPER_LIMIT_LATITUDE = 90.0;
 
+    /// If true, the handler does not write anything but records if an object would produce output.
+    bool m_selection_mode = false;
+
+    /// Set to true by selection_only() if the current object would produce output.
+    bool m_selected = false;
+
+    /// counters of the individual checks (only updated if enabled by --check-counters)
+    CheckCounters m_check_counters;
+
+    /// buffer of the strings returned by the tags_string methods
+    TagStringBuilder<MAX_FIELD_LENGTH> m_tags_builder;
+
+    /**
+     * Run a check step writing features and count it as fired if it wrote at least one feature.
+     *
+     * \param index index of the check in m_check_counters
+     * \param step callable running the check
+     */
+    template <typename TStep>
+    void counted_step(const size_t index, TStep&& step) {
+        if (!m_check_counters.enabled() || m_selection_mode) {
+            step();
+            return;
+        }
+        const size_t written_before = m_features_written;
+        m_check_counters.run(index, [&]() {
+            step();
+            return m_features_written != written_before;
+        });
+    }
+
+    /**
+     * Check if a write method should return without writing anything because we only want to
+     * know if the current object produces output (see way_produces_output).
+     *
+     * This method has to be called by all methods writing features before any geometry is
+     * built.
+     */
+    bool selection_only() {
+        if (m_selection_mode) {
+            m_selected = true;
+        }
+        return m_selection_mode;
+    }
+
+    /**
+     * Return true if the handler can decide whether a way produces output without knowing
+     * the locations of its nodes.
+     *
+     * Handlers returning true must call selection_only() in all methods writing features.
+     */
+    virtual bool supports_selection() const;
+
     /**
      * Check if all nodes of the way are valid.
      */
@@ -96,59 +154,106 @@ public:
 
     virtual ~AbstractViewHandler();
 
+    const CheckCounters& check_counters() const noexcept {
+        return m_check_counters;
+    }
+
     virtual void node(const osmium::Node&) = 0;
 
     virtual void way(const osmium::Way&) = 0;
 
     virtual void area(const osmium::Area&) = 0;
 
+    /**
+     * Check if a way would produce any output feature of this view.
+     *
+     * The checks are run without writing anything. Node locations are not required.
+     * If the handler does not support this (see supports_selection), true is returned.
+     */
+    bool way_produces_output(const osmium::Way& way);
+
+    /**
+     * Return true if only ways with certain keys (see way_has_relevant_keys) can produce
+     * output of this view.
+     */
+    virtual bool limited_by_keys() const;
+
+    /**
+     * Check if a way has any of the keys the output of this view depends on.
+     *
+     * This is a much cheaper but less selective test than way_produces_output.
+     */
+    virtual bool way_has_relevant_keys(const osmium::Way& way) const;
+
+    /**
+     * Keys of TagKey of which a node needs at least one to produce output of this view.
+     *
+     * HandlerCollection does not call node() for other nodes. The default (every_object)
+     * passes all nodes.
+     */
+    virtual key_mask_type node_key_interest() const;
+
+    /**
+     * Keys of TagKey of which a way needs at least one to produce output of this view.
+     *
+     * HandlerCollection does not call way() for other ways. The default (every_object)
+     * passes all ways.
+     */
+    virtual key_mask_type way_key_interest() const;
+
+    /**
+     * Return true if the handler processes many ways faster using way_batch() than using
+     * way() for each of them.
+     *
+     * HandlerCollection passes the ways of a whole buffer to way_batch() if the views are
+     * run on worker threads.
+     */
+    virtual bool supports_batches() const;
+
+    /**
+     * Process all ways of a batch in their order. The batch only contains ways whose keys
+     * match way_key_interest().
+     *
+     * The default implementation calls way() for each way.
+     */
+    virtual void way_batch(WayBatch& batch);
+
+    /**
+     * Build a string of the provided tags of an object.
+     *
+     * The returned string is valid until the next call of a tags_string method of this
+     * handler.
+     */
     template <size_t TKeyCount>
-    std::string selective_tags_str(const osmium::TagList& tags, const char separator, std::array<const char*, TKeyCount> keys) {
-        std::string tag_str;
+    const char* selective_tags_str(const osmium::TagList& tags, const char separator, std::array<const char*, TKeyCount> keys) {
+        m_tags_builder.reset();
         for (auto k : keys) {
             const char* value = tags.get_value_by_key(k);
-            if (!value) {
-                continue;
-            }
-            size_t add_length = strlen(value) + strlen(value) + 2;
-            if (add_length < 50 && tag_str.length() + add_length < MAX_FIELD_LENGTH) {
-                tag_str += k;
-                tag_str += '=';
-                tag_str += value;
-                tag_str += separator;
+            if (value) {
+                m_tags_builder.append(k, value, separator);
             }
         }
-        // remove last | from tag_str
-        if (!tag_str.empty()) {
-            tag_str.pop_back();
-        }
-        return tag_str;
+        return m_tags_builder.finish();
     }
 
     /**
      * Build a string of all tags of an object except the provided ones.
+     *
+     * The returned string is valid until the next call of a tags_string method of this
+     * handler.
      */
     template <size_t TKeyCount>
-    std::string tags_string(const osmium::TagList& tags, const char separator,
+    const char* tags_string(const osmium::TagList& tags, const char separator,
             std::array<const char*, TKeyCount> excluded_keys) {
-        std::string tag_str;
+        m_tags_builder.reset();
         for (const auto& tag : tags) {
             const char* key = tag.key();
             if (std::any_of(excluded_keys.begin(), excluded_keys.end(), [&key](const char* arr_val){return !strcmp(arr_val, key);})) {
                 continue;
             }
-            const char* value = tag.value();
-            size_t add_length = strlen(value) + strlen(value) + 2;
-            if (add_length < 50 && tag_str.length() + add_length < MAX_FIELD_LENGTH) {
-                tag_str += key;
-                tag_str += '=';
-                tag_str += value;
-                tag_str += separator;
-            }
+            m_tags_builder.append(key, tag.value(), separator);
         }
-        // remove last | from tag_str
-        tag_str.pop_back();
-        return tag_str;
+        return m_tags_builder.finish();
     }
 
     /**
@@ -160,9 +265,10 @@ public:
      * \param not_include key whose value should not be included in the string of all tags.
      * If it is a null pointer, this check is skipped.
      *
-     * \returns string with the tags
+     * \returns string with the tags, valid until the next call of a tags_string method of this
+     * handler
      */
-    std::string tags_string(const osmium::TagList& tags, const char* not_include);
+    const char* tags_string(const osmium::TagList& tags, const char* not_include);
 
     /**
      * Close all open layers and datasets.
@@ -18,11 +18,35 @@
  */
 
 
+#include <algorithm>
+
 #include "any_relation_collector.hpp"
 #include "tagging_view_handler.hpp"
 
+AnyRelationCollector::FirstPassHandler::FirstPassHandler(AnyRelationCollector& collector) :
+        m_collector(collector) { }
+
+void AnyRelationCollector::FirstPassHandler::relation(const osmium::Relation& relation) {
+    if (m_collector.enabled && m_collector.keep_relation(relation)) {
+        m_collector.add_relation(relation);
+    }
+}
+
+void AnyRelationCollector::FirstPassHandler::prepare_for_lookup() {
+    m_collector.sort_member_meta();
+}
+
 AnyRelationCollector::AnyRelationCollector(Options& options) :
-        OGROutputBase(options) { }
+        OGROutputBase(options),
+        enabled(false) { }
+
+void AnyRelationCollector::enable() {
+    enabled = true;
+}
+
+AnyRelationCollector::FirstPassHandler AnyRelationCollector::first_pass_handler() {
+    return FirstPassHandler{*this};
+}
 
 bool AnyRelationCollector::keep_relation(const osmium::Relation& relation) const {
     // whitelisted route=piste/ski/ferry because both can contain member ways without tags.
@@ -46,12 +70,20 @@ void AnyRelationCollector::way_not_in_any_relation(const osmium::Way& way) {
     try {
         std::unique_ptr<OGRGeometry> geometry;
         geometry =m_factory.create_linestring(way);
-        gdalcpp::Feature feature(*(m_tagging_ways_without_tags.get()), std::move(geometry));
+        OutputFeature feature(*(m_tagging_ways_without_tags.get()), std::move(geometry));
         TaggingViewHandler::set_basic_fields(feature, way, nullptr, nullptr);
-        feature.add_to_layer();
+        write_feature(feature);
     } catch (osmium::geometry_error& err) {
-        m_options.verbose_output << err.what() << "\n";
+        log_verbose(m_options.verbose_output, err.what(), "\n");
+    }
+}
+
+bool AnyRelationCollector::way_produces_output(const osmium::Way& way) {
+    if (way.tags().size() > 0 || !m_tagging_ways_without_tags) {
+        return false;
     }
+    const std::vector<osmium::relations::MemberMeta>& mmv = member_meta(osmium::item_type::way);
+    return !std::binary_search(mmv.cbegin(), mmv.cend(), osmium::relations::MemberMeta{way.id()});
 }
 
 void AnyRelationCollector::complete_relation(osmium::relations::RelationMeta&) {}
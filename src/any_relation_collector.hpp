@@ -22,6 +22,7 @@
 #define SRC_ANY_RELATION_COLLECTOR_HPP_
 
 #include <gdalcpp.hpp>
+#include <osmium/handler.hpp>
 #include <osmium/relations/collector.hpp>
 #include "ogr_output_base.hpp"
 
@@ -30,6 +31,8 @@ true, true, true>, public OGROutputBase {
 
     std::unique_ptr<gdalcpp::Layer> m_tagging_ways_without_tags;
 
+    bool enabled;
+
     static constexpr double UPPER_LIMIT_LATITUDE = 90.0;
 
     inline bool coordinates_valid(const osmium::Location location) {
@@ -51,12 +54,46 @@ true, true, true>, public OGROutputBase {
     }
 
 public:
+    /**
+     * Handler for the first pass feeding relations into the collector.
+     *
+     * In contrast to Collector::read_relations, this handler can be passed to
+     * osmium::relations::read_relations together with relation managers. This allows
+     * all relation collectors and managers to share a single read of the input file.
+     */
+    class FirstPassHandler : public osmium::handler::Handler {
+        AnyRelationCollector& m_collector;
+
+    public:
+        explicit FirstPassHandler(AnyRelationCollector& collector);
+
+        void relation(const osmium::Relation& relation);
+
+        /**
+         * Has to be called after the first pass (read_relations calls it for us).
+         */
+        void prepare_for_lookup();
+    };
+
     AnyRelationCollector() = delete;
 
     AnyRelationCollector(Options& options);
 
     static constexpr const char* layer_name = "tagging_ways_without_tags";
 
+    /**
+     * Activate this collector.
+     *
+     * This method has to be called before the first pass. Otherwise no relations are
+     * collected.
+     */
+    void enable();
+
+    /**
+     * Get a handler to be used in the first pass.
+     */
+    FirstPassHandler first_pass_handler();
+
     /**
      * This method decides which relations we're interested in, and
      * instructs Osmium to collect their members for us.
@@ -80,6 +117,13 @@ public:
      */
     void way_not_in_any_relation(const osmium::Way& way);
 
+    /**
+     * Check if a way will be written by way_not_in_any_relation. Node locations are not required.
+     *
+     * This method may only be called after the first pass.
+     */
+    bool way_produces_output(const osmium::Way& way);
+
     void complete_relation(osmium::relations::RelationMeta&);
 
     /**
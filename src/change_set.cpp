@@ -0,0 +1,81 @@
+/*
+ * change_set.cpp
+ *
+ *  Created on:  2026-10-18
+ */
+
+#include <osmium/io/any_input.hpp>
+#include <osmium/osm/object.hpp>
+
+#include "change_set.hpp"
+
+void ChangeSet::read_changes(const std::string& filename) {
+    osmium::io::Reader reader{filename, osmium::osm_entity_bits::nwr};
+    while (osmium::memory::Buffer buffer = reader.read()) {
+        for (const osmium::OSMObject& object : buffer.select<osmium::OSMObject>()) {
+            switch (object.type()) {
+            case osmium::item_type::node:
+                m_changed_nodes.set(object.positive_id());
+                break;
+            case osmium::item_type::way:
+                m_changed_ways.set(object.positive_id());
+                m_modified_ways.set(object.positive_id());
+                m_affected_ways.set(object.positive_id());
+                break;
+            case osmium::item_type::relation:
+                m_changed_relations.set(object.positive_id());
+                m_affected_relations.set(object.positive_id());
+                break;
+            default:
+                break;
+            }
+        }
+    }
+    reader.close();
+}
+
+void ChangeSet::way(const osmium::Way& way) {
+    if (m_changed_ways.get(way.positive_id())) {
+        return;
+    }
+    for (const osmium::NodeRef& nr : way.nodes()) {
+        if (m_changed_nodes.get(nr.positive_ref())) {
+            m_modified_ways.set(way.positive_id());
+            m_affected_ways.set(way.positive_id());
+            return;
+        }
+    }
+}
+
+void ChangeSet::relation(const osmium::Relation& relation) {
+    if (m_changed_relations.get(relation.positive_id())) {
+        // The features of the member ways may carry attributes of the relation. Other
+        // relations of these ways are not affected, therefore m_modified_ways is not touched.
+        for (const osmium::RelationMember& member : relation.members()) {
+            if (member.type() == osmium::item_type::way) {
+                m_affected_ways.set(member.positive_ref());
+            }
+        }
+        return;
+    }
+    for (const osmium::RelationMember& member : relation.members()) {
+        if ((member.type() == osmium::item_type::node && m_changed_nodes.get(member.positive_ref()))
+                || (member.type() == osmium::item_type::way && m_modified_ways.get(member.positive_ref()))
+                || (member.type() == osmium::item_type::relation && m_changed_relations.get(member.positive_ref()))) {
+            m_affected_relations.set(relation.positive_id());
+            return;
+        }
+    }
+}
+
+const id_set_type& ChangeSet::changed_nodes() const {
+    return m_changed_nodes;
+}
+
+const id_set_type& ChangeSet::affected_ways() const {
+    return m_affected_ways;
+}
+
+const id_set_type& ChangeSet::affected_relations() const {
+    return m_affected_relations;
+}
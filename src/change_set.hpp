@@ -0,0 +1,62 @@
+/*
+ * change_set.hpp
+ *
+ *  Created on:  2026-10-18
+ */
+
+#ifndef SRC_CHANGE_SET_HPP_
+#define SRC_CHANGE_SET_HPP_
+
+#include <string>
+
+#include <osmium/handler.hpp>
+#include <osmium/osm/relation.hpp>
+#include <osmium/osm/way.hpp>
+
+#include "selective_node_locations.hpp"
+
+/**
+ * Objects affected by an OSC change file.
+ *
+ * First, read the change file using read_changes(). Afterwards, apply this handler to the
+ * ways and relations of the current input file (the state after applying the changes) to
+ * find the ways and relations which are affected indirectly. Ways have to be read before
+ * relations.
+ *
+ * A way is affected if it was changed or deleted, if one of its nodes was changed or if it is
+ * a member of a changed relation. A relation is affected if it was changed or deleted or if
+ * one of its members was changed directly or by its nodes. Ways which are no longer members of
+ * a relation after the changes are not found because only the state after the changes is known.
+ */
+class ChangeSet : public osmium::handler::Handler {
+
+    id_set_type m_changed_nodes;
+    id_set_type m_changed_ways;
+    id_set_type m_changed_relations;
+
+    /// ways which were changed or whose nodes were changed
+    id_set_type m_modified_ways;
+
+    id_set_type m_affected_ways;
+    id_set_type m_affected_relations;
+
+public:
+    ChangeSet() = default;
+
+    /**
+     * Read a change file and remember the IDs of all changed, created and deleted objects.
+     */
+    void read_changes(const std::string& filename);
+
+    void way(const osmium::Way& way);
+
+    void relation(const osmium::Relation& relation);
+
+    const id_set_type& changed_nodes() const;
+
+    const id_set_type& affected_ways() const;
+
+    const id_set_type& affected_relations() const;
+};
+
+#endif /* SRC_CHANGE_SET_HPP_ */
@@ -0,0 +1,45 @@
+/*
+ * check_counters.cpp
+ *
+ *  Created on:  2026-10-18
+ */
+
+#include <iomanip>
+
+#include "check_counters.hpp"
+
+double CheckCounters::Counter::estimated_time() const {
+    if (timed == 0) {
+        return 0;
+    }
+    return std::chrono::duration<double>(sampled_time).count() * evaluated / timed;
+}
+
+CheckCounters::CheckCounters(const bool enabled) :
+        m_counters(),
+        m_enabled(enabled) {
+}
+
+size_t CheckCounters::add(std::string name) {
+    m_counters.emplace_back();
+    m_counters.back().name = std::move(name);
+    return m_counters.size() - 1;
+}
+
+void CheckCounters::print(std::ostream& out, const std::string& title) const {
+    if (m_counters.empty()) {
+        return;
+    }
+    const std::ios_base::fmtflags flags = out.flags();
+    const std::streamsize precision = out.precision();
+    out << "Check counters of " << title << ":\n"
+        << std::left << std::setw(40) << "  check" << std::right
+        << std::setw(14) << "evaluated" << std::setw(14) << "fired" << std::setw(12) << "time [s]\n";
+    for (const Counter& counter : m_counters) {
+        out << "  " << std::left << std::setw(38) << counter.name << std::right
+            << std::setw(14) << counter.evaluated << std::setw(14) << counter.fired
+            << std::setw(11) << std::fixed << std::setprecision(3) << counter.estimated_time() << '\n';
+    }
+    out.flags(flags);
+    out.precision(precision);
+}
@@ -0,0 +1,91 @@
+/*
+ * check_counters.hpp
+ *
+ *  Created on:  2026-10-18
+ */
+
+#ifndef SRC_CHECK_COUNTERS_HPP_
+#define SRC_CHECK_COUNTERS_HPP_
+
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include "run_statistics.hpp"
+
+/**
+ * Count how often each check of a view handler is evaluated and how often it fires, and
+ * measure the time spent in the check.
+ *
+ * To keep the overhead low, only every SAMPLE_INTERVAL-th evaluation of a check is timed.
+ * The reported time is extrapolated from these samples.
+ */
+class CheckCounters {
+public:
+    struct Counter {
+        std::string name;
+        uint64_t evaluated = 0;
+        uint64_t fired = 0;
+        uint64_t timed = 0;
+        stats_clock::duration sampled_time {0};
+
+        /// Return the estimated cumulative time of all evaluations in seconds.
+        double estimated_time() const;
+    };
+
+private:
+    static constexpr uint64_t SAMPLE_INTERVAL = 64;
+
+    std::vector<Counter> m_counters;
+
+    bool m_enabled;
+
+public:
+    explicit CheckCounters(const bool enabled);
+
+    bool enabled() const noexcept {
+        return m_enabled;
+    }
+
+    /**
+     * Register a check.
+     *
+     * \returns index of the check to be passed to run()
+     */
+    size_t add(std::string name);
+
+    /**
+     * Evaluate a check and update its counters.
+     *
+     * \param index index returned by add()
+     * \param check callable returning true if the check fired
+     *
+     * \returns return value of the check
+     */
+    template <typename TCheck>
+    bool run(const size_t index, TCheck&& check) {
+        Counter& counter = m_counters[index];
+        bool fired;
+        if (counter.evaluated++ % SAMPLE_INTERVAL == 0) {
+            const stats_clock::time_point start = stats_clock::now();
+            fired = check();
+            counter.sampled_time += stats_clock::now() - start;
+            ++counter.timed;
+        } else {
+            fired = check();
+        }
+        counter.fired += fired;
+        return fired;
+    }
+
+    /**
+     * Print a table of all counters. Nothing is printed if no check is registered.
+     *
+     * \param out stream to write to
+     * \param title heading of the table
+     */
+    void print(std::ostream& out, const std::string& title) const;
+};
+
+#endif /* SRC_CHECK_COUNTERS_HPP_ */
@@ -0,0 +1,76 @@
+/*
+ * dataset_writer.cpp
+ *
+ *  Created on:  2026-10-18
+ */
+
+#include "dataset_writer.hpp"
+
+DatasetWriter::DatasetWriter(const layer_writer_map* targets, const size_t queue_size) :
+        m_queue(queue_size, "dataset_writer"),
+        m_targets(targets),
+        m_thread(),
+        m_exception() {
+    m_thread = std::thread([this]() {
+        run();
+    });
+}
+
+DatasetWriter::~DatasetWriter() {
+    if (!m_finished) {
+        stop();
+    }
+}
+
+void DatasetWriter::run() {
+    while (true) {
+        OutputFeature feature;
+        m_queue.wait_and_pop(feature);
+        if (!feature.valid()) {
+            return;
+        }
+        // Keep on consuming the queue after a failure. Otherwise the handlers would block
+        // forever if the queue is full.
+        if (!m_failed) {
+            try {
+                FeatureWriter* target = nullptr;
+                if (m_targets) {
+                    auto it = m_targets->find(&(feature.layer()));
+                    if (it != m_targets->end()) {
+                        target = it->second;
+                    }
+                }
+                if (target) {
+                    target->write(std::move(feature));
+                } else {
+                    feature.write_to_layer();
+                }
+            } catch (...) {
+                m_exception = std::current_exception();
+                m_failed = true;
+            }
+        }
+    }
+}
+
+void DatasetWriter::write(OutputFeature&& feature) {
+    if (m_failed) {
+        std::rethrow_exception(m_exception);
+    }
+    m_queue.push(std::move(feature));
+}
+
+void DatasetWriter::stop() {
+    m_finished = true;
+    m_queue.push(OutputFeature{});
+    if (m_thread.joinable()) {
+        m_thread.join();
+    }
+}
+
+void DatasetWriter::finish() {
+    stop();
+    if (m_exception) {
+        std::rethrow_exception(m_exception);
+    }
+}
@@ -0,0 +1,80 @@
+/*
+ * dataset_writer.hpp
+ *
+ *  Created on:  2026-10-18
+ */
+
+#ifndef SRC_DATASET_WRITER_HPP_
+#define SRC_DATASET_WRITER_HPP_
+
+#include <atomic>
+#include <exception>
+#include <thread>
+
+#include <osmium/thread/queue.hpp>
+
+#include "feature_writer.hpp"
+
+/**
+ * Write features to the layers of the datasets of one view on a dedicated thread.
+ *
+ * The handlers build the features and push them into a bounded queue. The writer thread
+ * inserts them into their layers. Transaction commits of the datasets therefore do not block
+ * the handlers unless the queue is full. The datasets of different views are written by
+ * different threads at the same time.
+ *
+ * Only the writer thread may access the datasets and their layers after the first feature
+ * was pushed, except for creating new features (reading the layer definition).
+ */
+class DatasetWriter : public FeatureWriter {
+    osmium::thread::Queue<OutputFeature> m_queue;
+
+    /// writers used by the writer thread (nullptr or layers missing: write using OGR)
+    const layer_writer_map* m_targets;
+
+    std::thread m_thread;
+
+    /// first exception thrown by the writer thread
+    std::exception_ptr m_exception;
+
+    /// set after m_exception was set
+    std::atomic<bool> m_failed {false};
+
+    bool m_finished = false;
+
+    void run();
+
+    void stop();
+
+public:
+    /**
+     * \param targets writers of the layers to be used by the writer thread (has to outlive
+     * this object), nullptr to write all features using OGR
+     * \param queue_size maximum number of features waiting to be written
+     */
+    explicit DatasetWriter(const layer_writer_map* targets = nullptr, const size_t queue_size = 10000);
+
+    DatasetWriter(const DatasetWriter&) = delete;
+    DatasetWriter& operator=(const DatasetWriter&) = delete;
+
+    ~DatasetWriter();
+
+    /**
+     * Hand a feature over to the writer thread.
+     *
+     * This method blocks if the queue is full.
+     *
+     * \throws any exception thrown by the writer thread while writing an earlier feature
+     */
+    void write(OutputFeature&& feature) override;
+
+    /**
+     * Wait until all features have been written and stop the writer thread. The target
+     * writers are not finished.
+     *
+     * \throws any exception thrown by the writer thread
+     */
+    void finish() override;
+};
+
+#endif /* SRC_DATASET_WRITER_HPP_ */
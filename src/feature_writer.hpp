@@ -0,0 +1,37 @@
+/*
+ * feature_writer.hpp
+ *
+ *  Created on:  2026-10-18
+ */
+
+#ifndef SRC_FEATURE_WRITER_HPP_
+#define SRC_FEATURE_WRITER_HPP_
+
+#include <unordered_map>
+
+#include "output_feature.hpp"
+
+/**
+ * Interface of writers which take over writing features to the layers of a dataset.
+ *
+ * Features of layers without a writer are written by OGROutputBase::write_feature using OGR.
+ */
+class FeatureWriter {
+public:
+    virtual ~FeatureWriter() = default;
+
+    /**
+     * Write a feature.
+     */
+    virtual void write(OutputFeature&& feature) = 0;
+
+    /**
+     * Write all pending features. The writer must not be used afterwards.
+     */
+    virtual void finish() = 0;
+};
+
+/// writer of each layer which is not written by OGROutputBase itself
+using layer_writer_map = std::unordered_map<const gdalcpp::Layer*, FeatureWriter*>;
+
+#endif /* SRC_FEATURE_WRITER_HPP_ */
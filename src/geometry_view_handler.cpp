@@ -83,33 +83,20 @@ std::string GeometryViewHandler::view_name() const {
     return "geometry";
 }
 
-std::string GeometryViewHandler::tags_string(const osmium::TagList& tags) {
-    std::string tag_str;
-    // only add tags to the tags string if their key and value are shorter than 50 characters
-    for (const osmium::Tag& t : tags) {
-        size_t add_length = strlen(t.key()) + strlen(t.value()) + 2;
-        if (add_length < 50 && tag_str.length() + add_length < MAX_FIELD_LENGTH) {
-            tag_str += t.key();
-            tag_str += '=';
-            tag_str += t.value();
-            tag_str += '|';
-        }
-    }
-    // remove last | from tag_str
-    tag_str.pop_back();
-    return tag_str;
+const char* GeometryViewHandler::tags_string(const osmium::TagList& tags) {
+    return AbstractViewHandler::tags_string(tags, nullptr);
 }
 
 void GeometryViewHandler::handle_way_many_nodes(const osmium::Way& way) {
-    gdalcpp::Feature feature(*m_geometry_long_ways, m_factory.create_linestring(way));
+    OutputFeature feature(*m_geometry_long_ways, m_factory.create_linestring(way));
     static char idbuffer[20];
     sprintf(idbuffer, "%ld", way.id());
     feature.set_field("way_id", idbuffer);
     feature.set_field("length", static_cast<int>(way.nodes().size()));
     std::string the_timestamp (way.timestamp().to_iso());
     feature.set_field("lastchange", the_timestamp.c_str());
-    feature.set_field("tags", tags_string(way.tags()).c_str());
-    feature.add_to_layer();
+    feature.set_field("tags", tags_string(way.tags()));
+    write_feature(feature);
 }
 
 std::unique_ptr<OGRGeometry> GeometryViewHandler::build_linestring_from_segment(osmium::WayNodeList::const_iterator start,
@@ -132,14 +119,14 @@ bool GeometryViewHandler::check_segments_length(const osmium::Way& way) {
             long_segment = true;
             // build_linestring_from_segment(osmium::WayNodeList::const_iterator, osmium::WayNodeList::const_iterator)
             // has to be called with it+2 as second argument because this will be used as it != end in a for loop.
-            gdalcpp::Feature feature(*m_geometry_long_seg_seg, build_linestring_from_segment(it, (it + 2)));
+            OutputFeature feature(*m_geometry_long_seg_seg, build_linestring_from_segment(it, (it + 2)));
             static char idbuffer[20];
             sprintf(idbuffer, "%ld", way.id());
             feature.set_field("way_id", idbuffer);
             feature.set_field("length", static_cast<int>(length));
             std::string the_timestamp (way.timestamp().to_iso());
             feature.set_field("lastchange", the_timestamp.c_str());
-            feature.add_to_layer();
+            write_feature(feature);
         }
     }
     return long_segment;
@@ -147,29 +134,29 @@ bool GeometryViewHandler::check_segments_length(const osmium::Way& way) {
 
 void GeometryViewHandler::handle_long_segments(const osmium::Way& way) {
     if (check_segments_length(way)) {
-        gdalcpp::Feature feature(*m_geometry_long_seg_way, m_factory.create_linestring(way));
+        OutputFeature feature(*m_geometry_long_seg_way, m_factory.create_linestring(way));
         static char idbuffer[20];
         sprintf(idbuffer, "%ld", way.id());
         feature.set_field("way_id", idbuffer);
-        feature.set_field("tags", tags_string(way.tags()).c_str());
+        feature.set_field("tags", tags_string(way.tags()));
         std::string the_timestamp (way.timestamp().to_iso());
         feature.set_field("lastchange", the_timestamp.c_str());
-        feature.add_to_layer();
+        write_feature(feature);
     }
 }
 
 void GeometryViewHandler::single_node_in_way(const osmium::Way& way) {
-    gdalcpp::Feature feature(*m_geometry_single_node_in_way, m_factory.create_point(way.nodes().front()));
+    OutputFeature feature(*m_geometry_single_node_in_way, m_factory.create_point(way.nodes().front()));
     static char idbuffer[20];
     sprintf(idbuffer, "%ld", way.id());
     feature.set_field("way_id", idbuffer);
     static char idbuffer2[20];
     sprintf(idbuffer2, "%ld", way.nodes().front().ref());
     feature.set_field("node_id", idbuffer2);
-    feature.set_field("tags", tags_string(way.tags()).c_str());
+    feature.set_field("tags", tags_string(way.tags()));
     std::string the_timestamp (way.timestamp().to_iso());
     feature.set_field("lastchange", the_timestamp.c_str());
-    feature.add_to_layer();
+    write_feature(feature);
 }
 
 void GeometryViewHandler::duplicated_node_in_way(const osmium::Way& way) {
@@ -182,7 +169,7 @@ void GeometryViewHandler::duplicated_node_in_way(const osmium::Way& way) {
             continue;
         }
         if (it->ref() == next->ref() || (it->lat() == next->lat() && it->lon() == next->lon())) {
-            gdalcpp::Feature feature(*m_geometry_duplicate_node_in_way_node, m_factory.create_point(*it));
+            OutputFeature feature(*m_geometry_duplicate_node_in_way_node, m_factory.create_point(*it));
             static char idbuffer[20];
             sprintf(idbuffer, "%ld", way.id());
             feature.set_field("way_id", idbuffer);
@@ -191,15 +178,15 @@ void GeometryViewHandler::duplicated_node_in_way(const osmium::Way& way) {
             feature.set_field("node_id", idbuffer2);
             std::string the_timestamp (way.timestamp().to_iso());
             feature.set_field("lastchange", the_timestamp.c_str());
-            feature.add_to_layer();
+            write_feature(feature);
             if (!multiple_errors) {
-                gdalcpp::Feature way_feature(*m_geometry_duplicate_node_in_way_way, m_factory.create_linestring(way));
+                OutputFeature way_feature(*m_geometry_duplicate_node_in_way_way, m_factory.create_linestring(way));
                 way_feature.set_field("way_id", idbuffer);
                 way_feature.set_field("node_id", idbuffer2);
-                way_feature.set_field("tags", tags_string(way.tags()).c_str());
+                way_feature.set_field("tags", tags_string(way.tags()));
                 std::string the_timestamp (way.timestamp().to_iso());
                 way_feature.set_field("lastchange", the_timestamp.c_str());
-                way_feature.add_to_layer();
+                write_feature(way_feature);
             }
             multiple_errors = true;
         }
@@ -270,24 +257,24 @@ void GeometryViewHandler::add_self_intersection_way(const osmium::Way& way, bool
     if (already_flagged) {
         return;
     }
-    gdalcpp::Feature feature(*m_geometry_self_intersection_ways, m_factory.create_linestring(way));
+    OutputFeature feature(*m_geometry_self_intersection_ways, m_factory.create_linestring(way));
     static char idbuffer[20];
     sprintf(idbuffer, "%ld", way.id());
     feature.set_field("way_id", idbuffer);
-    feature.set_field("tags", tags_string(way.tags()).c_str());
-    feature.add_to_layer();
+    feature.set_field("tags", tags_string(way.tags()));
+    write_feature(feature);
 }
 
 void GeometryViewHandler::add_self_intersection_point(const osmium::Location& location, const osmium::object_id_type way_id,
         const osmium::object_id_type node_id /*= 0*/) {
-    gdalcpp::Feature feature(*m_geometry_self_intersection_points, m_factory.create_point(location));
+    OutputFeature feature(*m_geometry_self_intersection_points, m_factory.create_point(location));
     static char idbuffer[20];
     sprintf(idbuffer, "%ld", way_id);
     feature.set_field("way_id", idbuffer);
     static char idbuffer2[20];
     sprintf(idbuffer2, "%ld", node_id);
     feature.set_field("node_id", idbuffer2);
-    feature.add_to_layer();
+    write_feature(feature);
 }
 
 /**
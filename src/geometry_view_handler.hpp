@@ -31,7 +31,7 @@
 
 #include "abstract_view_handler.hpp"
 
-class GeometryViewHandler : public AbstractViewHandler {
+class GeometryViewHandler final : public AbstractViewHandler {
     /// layer for ways which have many nodes
     std::unique_ptr<gdalcpp::Layer> m_geometry_long_ways;
     /// layer for segments which are very long
@@ -68,7 +68,7 @@ class GeometryViewHandler : public AbstractViewHandler {
      * \param osm_object OSM object to be written
      * \param id ID of the OSM object
      */
-    void set_basic_fields(gdalcpp::Feature& feature, const osmium::OSMObject& osm_object,
+    void set_basic_fields(OutputFeature& feature, const osmium::OSMObject& osm_object,
             const osmium::object_id_type id);
 
     /**
@@ -88,8 +88,10 @@ class GeometryViewHandler : public AbstractViewHandler {
      * Build a string containing tags (length of key and value below 48 characters)
      * to be inserted into a "tag" column. The returned string is shorter than
      * MAX_FIELD_LENGTH characters. No keys or values will be truncated.
+     *
+     * The returned string is valid until the next call of a tags_string method.
      */
-    std::string tags_string(const osmium::TagList& tags);
+    const char* tags_string(const osmium::TagList& tags);
 
     /**
      * Build a linestring from a part of a WayNodeList.
@@ -149,11 +151,6 @@ class GeometryViewHandler : public AbstractViewHandler {
     void add_self_intersection_point(const osmium::Location& location, const osmium::object_id_type way_id,
             const osmium::object_id_type node_id = 0);
 
-    /**
-     * Check if the way has a self intersection and write the intersection points to the output layer.
-     */
-    void check_self_intersection(const osmium::Way& way);
-
     /**
      * Check if a way is degenerated.
      *
@@ -172,6 +169,11 @@ public:
 
     void way(const osmium::Way& way);
 
+    /**
+     * Check if the way has a self intersection and write the intersection points to the output layer.
+     */
+    void check_self_intersection(const osmium::Way& way);
+
     void node(const osmium::Node&) {};
     void relation(const osmium::Relation&) {};
     void area(const osmium::Area&) {};
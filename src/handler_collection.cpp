@@ -5,18 +5,165 @@
  *      Author: Michael Reichert <michael.reichert@geofabrik.de>
  */
 
+#include <algorithm>
+#include <tuple>
+
 #include "handler_collection.hpp"
+#include "shard_runner.hpp"
+#include "spatial_index.hpp"
+#include "verbose_log.hpp"
+
+namespace {
+
+    /**
+     * Properties of the handler classes known at compile time.
+     *
+     * node and way are false if the callback of the handler is empty.
+     */
+    template <typename THandler>
+    struct handler_traits;
+
+    template <>
+    struct handler_traits<GeometryViewHandler> {
+        static constexpr ViewType view = ViewType::geometry;
+        static constexpr bool node = false;
+        static constexpr bool way = true;
+    };
+
+    template <>
+    struct handler_traits<HighwayViewHandler> {
+        static constexpr ViewType view = ViewType::highways;
+        static constexpr bool node = true;
+        static constexpr bool way = true;
+    };
+
+    template <>
+    struct handler_traits<SacScaleViewHandler> {
+        static constexpr ViewType view = ViewType::sac_scale;
+        static constexpr bool node = true;
+        static constexpr bool way = true;
+    };
+
+    template <>
+    struct handler_traits<TaggingViewHandler> {
+        static constexpr ViewType view = ViewType::tagging;
+        static constexpr bool node = true;
+        static constexpr bool way = true;
+    };
+
+    template <>
+    struct handler_traits<PlacesHandler> {
+        static constexpr ViewType view = ViewType::places;
+        static constexpr bool node = true;
+        static constexpr bool way = false;
+    };
+
+    /**
+     * Check if an object with the keys in keys (see TagDigest::key_mask) is of interest for
+     * a handler whose key interest is interest.
+     */
+    inline bool interested(const key_mask_type keys, const key_mask_type interest) noexcept {
+        return keys & interest;
+    }
+
+    // The handler classes are final. Therefore the compiler can call (and inline) the
+    // callbacks directly instead of looking them up in the vtable.
+    template <typename THandler>
+    inline void static_node(THandler* handler, const key_mask_type keys, const key_mask_array& interest,
+            const osmium::Node& node) {
+        if constexpr (handler_traits<THandler>::node) {
+            if (handler && interested(keys, interest[static_cast<size_t>(handler_traits<THandler>::view)])) {
+                handler->node(node);
+            }
+        }
+    }
+
+    template <typename THandler>
+    inline void static_way(THandler* handler, const key_mask_type keys, const key_mask_array& interest,
+            const osmium::Way& way) {
+        if constexpr (handler_traits<THandler>::way) {
+            if (handler && interested(keys, interest[static_cast<size_t>(handler_traits<THandler>::view)])) {
+                handler->way(way);
+            }
+        }
+    }
+
+    template <typename THandler>
+    inline void static_view_node(THandler* handler, const ViewType view, const key_mask_type keys,
+            const key_mask_array& interest, const osmium::Node& node) {
+        if (view == handler_traits<THandler>::view) {
+            static_node(handler, keys, interest, node);
+        }
+    }
+
+    template <typename THandler>
+    inline void static_view_way(THandler* handler, const ViewType view, const key_mask_type keys,
+            const key_mask_array& interest, const osmium::Way& way) {
+        if (view == handler_traits<THandler>::view) {
+            static_way(handler, keys, interest, way);
+        }
+    }
+
+} // namespace
 
 HandlerCollection::HandlerCollection(Options& options) :
     m_options(options),
     m_datasets()/*,
-    m_dataset_names()*/ {}
+    m_dataset_names()*/,
+    m_layer_writers(),
+    m_native_layer_writers(),
+    m_writer_layers(),
+    m_layer_fields(),
+    m_view_writers(),
+    m_views(),
+    m_view_timing() {
+    for (auto vt : m_options.views) {
+        if (std::find(m_views.begin(), m_views.end(), vt) == m_views.end()) {
+            m_views.push_back(vt);
+        }
+    }
+}
 
 HandlerCollection::DatasetWithView::DatasetWithView(ViewType v, std::unique_ptr<gdalcpp::Dataset>&& d) :
         view(v),
         dataset(std::move(d)) {}
 
+void HandlerCollection::open_writers() {
+    for (auto& vd : m_datasets) {
+        if (vd.native_writer) {
+            vd.native_writer->open();
+        }
+    }
+    if (!m_writer_layers.empty()) {
+        // The handlers must not read the definitions of the layers while the writer threads
+        // write to them. The features of these layers are copied for their writer, all
+        // other features are built as OGR features.
+        for (gdalcpp::Layer* layer : m_writer_layers) {
+            m_layer_fields.emplace(layer, LayerFields{*layer});
+        }
+        OutputFeature::set_layer_fields(&m_layer_fields);
+    }
+}
+
+void HandlerCollection::finish_writers() {
+    for (auto& writer : m_view_writers) {
+        if (writer) {
+            writer->finish();
+        }
+    }
+    for (auto& vd : m_datasets) {
+        if (vd.native_writer) {
+            vd.native_writer->finish();
+        }
+    }
+}
+
 void HandlerCollection::give_correct_name() {
+    // The layers must not be touched by the writer threads anymore when the handlers close them.
+    finish_writers();
+    OutputFeature::set_layer_fields(nullptr);
+    // names of the datasets of each view
+    std::vector<std::pair<std::string, std::vector<std::string>>> closed_datasets;
     for (auto& h : m_handlers) {
         h->close();
         switch (h->view_type()) {
@@ -38,12 +185,28 @@ void HandlerCollection::give_correct_name() {
         default:
             break;
         }
-        rename_output_files(h->view_name(), close_datasets(h->view_type()));
+        closed_datasets.emplace_back(h->view_name(), close_datasets(h->view_type()));
     }
     // Views without an instance of AbstractViewHandler
     if (turn_restrictions_manager) {
         turn_restrictions_manager->close();
-        rename_output_files(TurnRestrictionsManager::view_name(), close_datasets(ViewType::turn_restrictions));
+        closed_datasets.emplace_back(TurnRestrictionsManager::view_name(), close_datasets(ViewType::turn_restrictions));
+    }
+    // In update mode, the datasets are temporary. Their features are merged into the existing
+    // datasets whose spatial indexes are kept up to date by the triggers of the index.
+    if (m_options.spatial_index && m_options.changes_file.empty()) {
+        std::vector<std::string> filenames;
+        for (auto& c : closed_datasets) {
+            filenames.insert(filenames.end(), c.second.begin(), c.second.end());
+        }
+        try {
+            build_spatial_indexes(filenames, m_options.verbose_output);
+        } catch (std::runtime_error& err) {
+            throw std::runtime_error{std::string{"Building the spatial indexes failed: "} + err.what()};
+        }
+    }
+    for (auto& c : closed_datasets) {
+        rename_output_files(c.first, std::move(c.second));
     }
 }
 
@@ -56,6 +219,10 @@ std::vector<std::string> HandlerCollection::close_datasets(const ViewType view_t
         }
         dataset_names.push_back(d.dataset->dataset_name());
         d.dataset.reset();
+        if (d.native_writer) {
+            // OGR has written its own statistics which do not know about the native inserts.
+            d.native_writer->write_statistics();
+        }
     }
     return dataset_names;
 }
@@ -65,6 +232,8 @@ std::string HandlerCollection::filename_suffix() {
         return ".json";
     } else if (Options::case_insensitive_comp_left(m_options.output_format, "sqlite")) {
         return ".db";
+    } else if (m_options.flatgeobuf()) {
+        return ".fgb";
     }
     return "";
 }
@@ -84,7 +253,8 @@ void HandlerCollection::rename_output_files(const std::string& view_name,
                 std::cerr << "ERROR: Rename from " << dataset_names.front() << " to " << destination_name << "failed.\n";
             }
         }
-    } else if (dataset_names.size() > 1 && filename_suffix().length()) {
+    } else if (dataset_names.size() > 1 && filename_suffix().length() && !m_options.flatgeobuf()) {
+        // FlatGeobuf datasets have got their suffix when they were created.
         for (auto& d: dataset_names) {
             std::string destination_name = d;
             destination_name += filename_suffix();
@@ -113,8 +283,13 @@ std::vector<std::string> HandlerCollection::get_gdal_default_dataset_options() {
     std::vector<std::string> default_options;
     // default layer creation options
     if (m_options.output_format == "SQlite") {
-        CPLSetConfigOption("OGR_SQLITE_PRAGMA", "journal_mode=OFF,TEMP_STORE=MEMORY,temp_store=memory,LOCKING_MODE=EXCLUSIVE");
-        CPLSetConfigOption("OGR_SQLITE_CACHE", "600");
+        if (m_options.native_sqlite) {
+            // The native writer opens a second connection to the database.
+            CPLSetConfigOption("OGR_SQLITE_PRAGMA", "journal_mode=OFF,TEMP_STORE=MEMORY,temp_store=memory");
+        } else {
+            CPLSetConfigOption("OGR_SQLITE_PRAGMA", "journal_mode=OFF,TEMP_STORE=MEMORY,temp_store=memory,LOCKING_MODE=EXCLUSIVE");
+        }
+        CPLSetConfigOption("OGR_SQLITE_CACHE", std::to_string(m_options.sqlite_cache).c_str());
         CPLSetConfigOption("OGR_SQLITE_JOURNAL", "OFF");
         CPLSetConfigOption("OGR_SQLITE_SYNCHRONOUS", "OFF");
         default_options.emplace_back("SPATIALITE=YES");
@@ -138,11 +313,19 @@ HandlerCollection::DatasetWithView* HandlerCollection::ensure_writeable_dataset(
     std::string output_filename = m_options.output_directory;
     output_filename += '/';
     output_filename += layer_name;
+    if (m_options.flatgeobuf()) {
+        // Otherwise the driver creates a directory.
+        output_filename += filename_suffix();
+    }
     std::unique_ptr<gdalcpp::Dataset> ds {new gdalcpp::Dataset(m_options.output_format,
             output_filename, gdalcpp::SRS(m_options.srs), get_gdal_default_dataset_options())};
     ds->enable_auto_transactions(10000);
     m_datasets.emplace_back(view, std::move(ds));
-    return &(m_datasets.back());
+    DatasetWithView& dv = m_datasets.back();
+    if (m_options.native_sqlite) {
+        dv.native_writer.reset(new SpatialiteWriter(*(dv.dataset), output_filename));
+    }
+    return &dv;
 }
 
 std::vector<std::string> HandlerCollection::get_gdal_default_layer_options() {
@@ -153,6 +336,9 @@ std::vector<std::string> HandlerCollection::get_gdal_default_layer_options() {
         default_options.emplace_back("COMPRESS_GEOM=NO");
     } else if (m_options.output_format == "ESRI Shapefile") {
         default_options.emplace_back("SHAPE_ENCODING=UTF8");
+    } else if (m_options.flatgeobuf()) {
+        // packed Hilbert R-tree written at the beginning of the file when it is closed
+        default_options.emplace_back("SPATIAL_INDEX=YES");
     }
 
     return default_options;
@@ -160,8 +346,25 @@ std::vector<std::string> HandlerCollection::get_gdal_default_layer_options() {
 
 std::unique_ptr<gdalcpp::Layer> HandlerCollection::create_layer(const ViewType view, const char* layer_name, OGRwkbGeometryType type) {
     DatasetWithView* dv = ensure_writeable_dataset(view, layer_name);
-    return std::unique_ptr<gdalcpp::Layer>{new gdalcpp::Layer(*(dv->dataset),
+    std::unique_ptr<gdalcpp::Layer> layer {new gdalcpp::Layer(*(dv->dataset),
             layer_name, type, get_gdal_default_layer_options())};
+    if (dv->native_writer) {
+        dv->native_writer->add_layer(*layer);
+        m_native_layer_writers[layer.get()] = dv->native_writer.get();
+    }
+    if (m_options.writer_threads) {
+        // All datasets of a view are written by the same thread.
+        std::unique_ptr<DatasetWriter>& writer = m_view_writers.at(static_cast<size_t>(view));
+        if (!writer) {
+            writer.reset(new DatasetWriter(&m_native_layer_writers, m_options.writer_queue_size));
+        }
+        m_layer_writers[layer.get()] = writer.get();
+        m_writer_layers.push_back(layer.get());
+    } else if (dv->native_writer) {
+        m_layer_writers[layer.get()] = dv->native_writer.get();
+        m_writer_layers.push_back(layer.get());
+    }
+    return layer;
 }
 
 void HandlerCollection::add_handler(const ViewType view) {
@@ -172,19 +375,38 @@ void HandlerCollection::add_handler(const ViewType view) {
 
     std::unique_ptr<AbstractViewHandler> handler;
     if (view == ViewType::geometry) {
-        handler.reset(new GeometryViewHandler(m_options, cl));
+        GeometryViewHandler* geometry_handler = new GeometryViewHandler(m_options, cl);
+        handler.reset(geometry_handler);
+        add_static_handler(geometry_handler);
     } else if (view == ViewType::highways) {
-        handler.reset(new HighwayViewHandler(m_options, cl));
+        HighwayViewHandler* highway_handler = new HighwayViewHandler(m_options, cl);
+        handler.reset(highway_handler);
+        add_static_handler(highway_handler);
     } else if (view == ViewType::sac_scale) {
-        handler.reset(new SacScaleViewHandler(m_options, cl));
+        SacScaleViewHandler* sac_scale_handler = new SacScaleViewHandler(m_options, cl);
+        handler.reset(sac_scale_handler);
+        add_static_handler(sac_scale_handler);
     } else if (view == ViewType::tagging) {
-        handler.reset(new TaggingViewHandler(m_options, cl));
+        TaggingViewHandler* tagging_handler = new TaggingViewHandler(m_options, cl);
+        handler.reset(tagging_handler);
+        add_static_handler(tagging_handler);
     } else if (view == ViewType::places) {
         handler.reset(new PlacesHandler(m_options, cl));
         m_places_handler = dynamic_cast<PlacesHandler*>(handler.get());
+        add_static_handler(m_places_handler);
     } else {
         return;
     }
+    handler->set_layer_writers(&m_layer_writers);
+    // The batch of a view is passed to one handler only.
+    const bool first_of_view = std::none_of(m_handlers.begin(), m_handlers.end(),
+            [view](const std::unique_ptr<AbstractViewHandler>& h) { return h->view_type() == view; });
+    m_batch_views.at(static_cast<size_t>(view)) = first_of_view && handler->supports_batches();
+    // Two handlers of the same view share the slot, both have to get their objects.
+    m_node_interest.at(static_cast<size_t>(view)) |= handler->node_key_interest();
+    m_way_interest.at(static_cast<size_t>(view)) |= handler->way_key_interest();
+    m_unbatched_way_interest.at(static_cast<size_t>(view)) = m_batch_views.at(static_cast<size_t>(view))
+            ? 0 : m_way_interest.at(static_cast<size_t>(view));
     m_handlers.push_back(std::move(handler));
 }
 
@@ -195,6 +417,7 @@ void HandlerCollection::set_any_relation_collector(AnyRelationCollector& collect
         return this->create_layer(ViewType::tagging, layer_name, type);
     };
     any_relation_collector->create_layer(cl);
+    any_relation_collector->set_layer_writers(&m_layer_writers);
 }
 
 void HandlerCollection::set_highway_relation_manager(HighwayRelationManager& manager) {
@@ -204,6 +427,7 @@ void HandlerCollection::set_highway_relation_manager(HighwayRelationManager& man
         return this->create_layer(ViewType::highways, layer_name, type);
     };
     highway_relation_collector->create_layer(cl);
+    highway_relation_collector->set_layer_writers(&m_layer_writers);
 }
 
 void HandlerCollection::set_turn_restrictions_manager(TurnRestrictionsManager& manager) {
@@ -213,6 +437,7 @@ void HandlerCollection::set_turn_restrictions_manager(TurnRestrictionsManager& m
         return this->create_layer(ViewType::turn_restrictions, layer_name, type);
     };
     turn_restrictions_manager->create_layer(cl);
+    turn_restrictions_manager->set_layer_writers(&m_layer_writers);
 }
 
 void HandlerCollection::add_multipolygon_collector(osmium::area::MultipolygonCollector<osmium::area::Assembler>& collector) {
@@ -222,9 +447,96 @@ void HandlerCollection::add_multipolygon_collector(osmium::area::MultipolygonCol
         }));
 }
 
-void HandlerCollection::node(const osmium::Node& node) {
+void HandlerCollection::set_way_filter(const id_set_type* filter) {
+    m_way_filter = filter;
+}
+
+void HandlerCollection::set_node_filter(const id_set_type* filter) {
+    m_node_filter = filter;
+}
+
+bool HandlerCollection::way_produces_output(const osmium::Way& way) {
+    m_tag_digest.update(way.tags());
+    TagDigest::Scope digest_scope {m_tag_digest};
     for (std::unique_ptr<AbstractViewHandler>& handler : m_handlers) {
-        handler->node(node);
+        if (handler->way_produces_output(way)) {
+            return true;
+        }
+    }
+    return any_relation_collector && any_relation_collector->way_produces_output(way);
+}
+
+bool HandlerCollection::limited_by_keys() const {
+    if (m_mp_collector_handler2 || any_relation_collector) {
+        return false;
+    }
+    for (const std::unique_ptr<AbstractViewHandler>& handler : m_handlers) {
+        if (!handler->limited_by_keys()) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool HandlerCollection::way_has_relevant_keys(const osmium::Way& way) const {
+    for (const std::unique_ptr<AbstractViewHandler>& handler : m_handlers) {
+        if (handler->way_has_relevant_keys(way)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+template <typename TManager>
+static void add_member_ways(TManager& manager, id_set_type& ids) {
+    manager.for_each_incomplete_relation([&ids](const osmium::relations::RelationHandle& handle) {
+        for (const osmium::RelationMember& member : (*handle).members()) {
+            if (member.type() == osmium::item_type::way && member.ref() != 0) {
+                ids.set(member.positive_ref());
+            }
+        }
+    });
+}
+
+void HandlerCollection::add_relation_member_ways(id_set_type& ids) {
+    if (highway_relation_collector) {
+        add_member_ways(*highway_relation_collector, ids);
+    }
+    if (turn_restrictions_manager) {
+        add_member_ways(*turn_restrictions_manager, ids);
+    }
+}
+
+bool HandlerCollection::in_shard(const osmium::Location& location) const {
+    if (m_options.shard_count <= 1) {
+        return true;
+    }
+    return location_shard(location, m_options.shard_count) == m_options.shard_index;
+}
+
+bool HandlerCollection::in_shard(const osmium::Way& way) const {
+    if (way.nodes().empty()) {
+        return in_shard(osmium::Location{});
+    }
+    return in_shard(way.nodes().front().location());
+}
+
+void HandlerCollection::node(const osmium::Node& node) {
+    if ((!m_node_filter || m_node_filter->get(node.positive_id())) && in_shard(node.location())) {
+        m_tag_digest.update(node.tags());
+        TagDigest::Scope digest_scope {m_tag_digest};
+        const key_mask_type keys = m_tag_digest.key_mask();
+        if (m_static_dispatch) {
+            std::apply([this, keys, &node](auto*... handlers) {
+                (static_node(handlers, keys, m_node_interest, node), ...);
+            }, m_static_handlers);
+        } else {
+            for (std::unique_ptr<AbstractViewHandler>& handler : m_handlers) {
+                if (interested(keys, handler->node_key_interest())) {
+                    handler->node(node);
+                }
+            }
+        }
     }
     if (m_mp_collector_handler2) {
         m_mp_collector_handler2->node(node);
@@ -241,15 +553,40 @@ void HandlerCollection::node(const osmium::Node& node) {
 }
 
 void HandlerCollection::way(const osmium::Way& way) {
+    if (m_way_filter && !m_way_filter->get(way.positive_id())) {
+        return;
+    }
     try {
-        for (std::unique_ptr<AbstractViewHandler>& handler  : m_handlers) {
-            handler->way(way);
-        }
-        if (m_mp_collector_handler2) {
-            m_mp_collector_handler2->way(way);
-        }
-        if (any_relation_collector) {
-            any_relation_collector->handler().way(way);
+        // Relation managers need all member ways, even if they belong to another shard.
+        if (in_shard(way)) {
+            m_tag_digest.update(way.tags());
+            TagDigest::Scope digest_scope {m_tag_digest};
+            const key_mask_type keys = m_tag_digest.key_mask();
+            // Handlers supporting batches get the way in flush().
+            if (m_static_dispatch) {
+                std::apply([this, keys, &way](auto*... handlers) {
+                    (static_way(handlers, keys, m_unbatched_way_interest, way), ...);
+                }, m_static_handlers);
+            } else {
+                for (std::unique_ptr<AbstractViewHandler>& handler  : m_handlers) {
+                    if (!m_batch_views[static_cast<size_t>(handler->view_type())]
+                            && interested(keys, handler->way_key_interest())) {
+                        handler->way(way);
+                    }
+                }
+            }
+            for (const ViewType view : m_views) {
+                const size_t view_index = static_cast<size_t>(view);
+                if (m_batch_views[view_index] && interested(keys, m_way_interest[view_index])) {
+                    m_view_batches[view_index].add(way, m_tag_digest);
+                }
+            }
+            if (m_mp_collector_handler2) {
+                m_mp_collector_handler2->way(way);
+            }
+            if (any_relation_collector) {
+                any_relation_collector->handler().way(way);
+            }
         }
         if (highway_relation_collector) {
             highway_relation_collector->handler().way(way);
@@ -258,7 +595,7 @@ void HandlerCollection::way(const osmium::Way& way) {
             turn_restrictions_manager->handler().way(way);
         }
     } catch (osmium::invalid_location& err) {
-        m_options.verbose_output << err.what() << '\n';
+        log_verbose(m_options.verbose_output, err.what(), '\n');
     }
 }
 
@@ -280,7 +617,7 @@ void HandlerCollection::relation(const osmium::Relation& relation) {
             turn_restrictions_manager->handler().relation(relation);
         }
     } catch (osmium::invalid_location& err) {
-        m_options.verbose_output << err.what() << '\n';
+        log_verbose(m_options.verbose_output, err.what(), '\n');
     }
 }
 
@@ -290,12 +627,16 @@ void HandlerCollection::area(const osmium::Area& area) {
             handler->area(area);
         }
     } catch (osmium::invalid_location& err) {
-        m_options.verbose_output << err.what() << '\n';
+        log_verbose(m_options.verbose_output, err.what(), '\n');
     }
 }
 
 
 void HandlerCollection::flush() {
+    // The ways are only valid as long as the buffer.
+    for (const ViewType view : m_views) {
+        view_way_batch(view, m_view_batches[static_cast<size_t>(view)]);
+    }
     for (std::unique_ptr<AbstractViewHandler>& handler : m_handlers) {
         handler->flush();
     }
@@ -312,3 +653,198 @@ void HandlerCollection::flush() {
         turn_restrictions_manager->handler().flush();
     }
 }
+
+void HandlerCollection::view_node(const ViewType view, const osmium::Node& node) {
+    if ((!m_node_filter || m_node_filter->get(node.positive_id())) && in_shard(node.location())) {
+        // Each view is processed by one thread only and has its own digest.
+        TagDigest& digest = m_view_digests.at(static_cast<size_t>(view));
+        digest.update(node.tags());
+        TagDigest::Scope digest_scope {digest};
+        const key_mask_type keys = digest.key_mask();
+        if (m_static_dispatch) {
+            std::apply([this, view, keys, &node](auto*... handlers) {
+                (static_view_node(handlers, view, keys, m_node_interest, node), ...);
+            }, m_static_handlers);
+        } else {
+            for (std::unique_ptr<AbstractViewHandler>& handler : m_handlers) {
+                if (handler->view_type() == view && interested(keys, handler->node_key_interest())) {
+                    handler->node(node);
+                }
+            }
+        }
+    }
+    if (view == ViewType::places && m_mp_collector_handler2) {
+        m_mp_collector_handler2->node(node);
+    } else if (view == ViewType::tagging && any_relation_collector) {
+        any_relation_collector->handler().node(node);
+    } else if (view == ViewType::highways && highway_relation_collector) {
+        highway_relation_collector->handler().node(node);
+    } else if (view == ViewType::turn_restrictions && turn_restrictions_manager) {
+        turn_restrictions_manager->handler().node(node);
+    }
+}
+
+void HandlerCollection::view_way(const ViewType view, const osmium::Way& way, WayBatch* batch) {
+    if (m_way_filter && !m_way_filter->get(way.positive_id())) {
+        return;
+    }
+    try {
+        const bool own_way = in_shard(way);
+        const size_t view_index = static_cast<size_t>(view);
+        if (own_way && batch && m_batch_views[view_index]) {
+            TagDigest& digest = m_view_digests[view_index];
+            digest.update(way.tags());
+            if (interested(digest.key_mask(), m_way_interest[view_index])) {
+                batch->add(way, digest);
+            }
+        } else if (own_way) {
+            TagDigest& digest = m_view_digests[view_index];
+            digest.update(way.tags());
+            TagDigest::Scope digest_scope {digest};
+            const key_mask_type keys = digest.key_mask();
+            if (m_static_dispatch) {
+                std::apply([this, view, keys, &way](auto*... handlers) {
+                    (static_view_way(handlers, view, keys, m_way_interest, way), ...);
+                }, m_static_handlers);
+            } else {
+                for (std::unique_ptr<AbstractViewHandler>& handler : m_handlers) {
+                    if (handler->view_type() == view && interested(keys, handler->way_key_interest())) {
+                        handler->way(way);
+                    }
+                }
+            }
+        }
+        if (view == ViewType::places && m_mp_collector_handler2) {
+            if (own_way) {
+                m_mp_collector_handler2->way(way);
+            }
+        } else if (view == ViewType::tagging && any_relation_collector) {
+            if (own_way) {
+                any_relation_collector->handler().way(way);
+            }
+        } else if (view == ViewType::highways && highway_relation_collector) {
+            highway_relation_collector->handler().way(way);
+        } else if (view == ViewType::turn_restrictions && turn_restrictions_manager) {
+            turn_restrictions_manager->handler().way(way);
+        }
+    } catch (osmium::invalid_location& err) {
+        log_verbose(m_options.verbose_output, err.what(), '\n');
+    }
+}
+
+void HandlerCollection::view_flush(const ViewType view) {
+    for (std::unique_ptr<AbstractViewHandler>& handler : m_handlers) {
+        if (handler->view_type() == view) {
+            handler->flush();
+        }
+    }
+    if (view == ViewType::places && m_mp_collector_handler2) {
+        m_mp_collector_handler2->flush();
+    } else if (view == ViewType::tagging && any_relation_collector) {
+        any_relation_collector->handler().flush();
+    } else if (view == ViewType::highways && highway_relation_collector) {
+        highway_relation_collector->handler().flush();
+    } else if (view == ViewType::turn_restrictions && turn_restrictions_manager) {
+        turn_restrictions_manager->handler().flush();
+    }
+}
+
+void HandlerCollection::view_way_batch(const ViewType view, WayBatch& batch) {
+    if (batch.empty()) {
+        return;
+    }
+    for (std::unique_ptr<AbstractViewHandler>& handler : m_handlers) {
+        if (handler->view_type() == view) {
+            handler->way_batch(batch);
+        }
+    }
+    for (const std::string& error : batch.errors()) {
+        log_verbose(m_options.verbose_output, error, '\n');
+    }
+    batch.clear();
+}
+
+void HandlerCollection::apply_to_view(const ViewType view, const osmium::memory::Buffer& buffer) {
+    const stats_clock::time_point start = collect_statistics() ? stats_clock::now() : stats_clock::time_point{};
+    size_t objects = 0;
+    WayBatch& batch = m_view_batches.at(static_cast<size_t>(view));
+    for (const auto& item : buffer) {
+        if (item.type() == osmium::item_type::node) {
+            view_node(view, static_cast<const osmium::Node&>(item));
+            ++objects;
+        } else if (item.type() == osmium::item_type::way) {
+            view_way(view, static_cast<const osmium::Way&>(item), &batch);
+            ++objects;
+        }
+    }
+    // The ways are only valid as long as the buffer.
+    view_way_batch(view, batch);
+    view_flush(view);
+    if (collect_statistics()) {
+        // Each view is run by a single thread only. No locking required.
+        ViewTiming& timing = view_timing(view);
+        timing.time += stats_clock::now() - start;
+        timing.objects += objects;
+    }
+}
+
+void HandlerCollection::apply_buffer(const osmium::memory::Buffer& buffer) {
+    if (collect_statistics() && m_views.size() > 1) {
+        // Views are independent from each other. Pass the buffer to one view after another
+        // to measure the time spent in each view.
+        for (const ViewType view : m_views) {
+            apply_to_view(view, buffer);
+        }
+        return;
+    }
+    const stats_clock::time_point start = collect_statistics() ? stats_clock::now() : stats_clock::time_point{};
+    size_t objects = 0;
+    for (const auto& item : buffer) {
+        if (item.type() == osmium::item_type::node) {
+            node(static_cast<const osmium::Node&>(item));
+            ++objects;
+        } else if (item.type() == osmium::item_type::way) {
+            way(static_cast<const osmium::Way&>(item));
+            ++objects;
+        }
+    }
+    flush();
+    if (collect_statistics() && !m_views.empty()) {
+        ViewTiming& timing = view_timing(m_views.front());
+        timing.time += stats_clock::now() - start;
+        timing.objects += objects;
+    }
+}
+
+void HandlerCollection::add_statistics(RunStatistics& statistics) const {
+    for (const ViewType view : m_views) {
+        ViewStatistics view_statistics;
+        for (const std::unique_ptr<AbstractViewHandler>& handler : m_handlers) {
+            if (handler->view_type() == view) {
+                view_statistics.name = handler->view_name();
+                view_statistics.add_output(handler->output_statistics());
+            }
+        }
+        if (view == ViewType::tagging && any_relation_collector) {
+            view_statistics.add_output(any_relation_collector->output_statistics());
+        } else if (view == ViewType::highways && highway_relation_collector) {
+            view_statistics.add_output(highway_relation_collector->output_statistics());
+        } else if (view == ViewType::turn_restrictions && turn_restrictions_manager) {
+            view_statistics.name = TurnRestrictionsManager::view_name();
+            view_statistics.add_output(turn_restrictions_manager->output_statistics());
+        }
+        const ViewTiming& timing = m_view_timing.at(static_cast<size_t>(view));
+        view_statistics.objects = timing.objects;
+        // OGR writes happen inside the handlers.
+        if (timing.time > view_statistics.ogr_time) {
+            view_statistics.handler_time = timing.time - view_statistics.ogr_time;
+        }
+        statistics.add_view(std::move(view_statistics));
+    }
+}
+
+void HandlerCollection::print_check_counters(std::ostream& out) const {
+    for (const std::unique_ptr<AbstractViewHandler>& handler : m_handlers) {
+        handler->check_counters().print(out, handler->view_name());
+    }
+}
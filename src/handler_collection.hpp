@@ -8,6 +8,9 @@
 #ifndef SRC_HANDLER_COLLECTION_HPP_
 #define SRC_HANDLER_COLLECTION_HPP_
 
+#include <array>
+#include <tuple>
+
 #include <gdalcpp.hpp>
 #include <osmium/area/multipolygon_collector.hpp>
 #include <osmium/area/assembler.hpp>
@@ -18,9 +21,17 @@
 #include "places_handler.hpp"
 #include "tagging_view_handler.hpp"
 #include "any_relation_collector.hpp"
+#include "dataset_writer.hpp"
+#include "spatialite_writer.hpp"
 #include "highway_relation_manager.hpp"
 #include "turn_restrictions_manager.hpp"
 #include "sac_scale_view_handler.hpp"
+#include "run_statistics.hpp"
+#include "selective_node_locations.hpp"
+#include "tag_digest.hpp"
+
+/// key interest (see AbstractViewHandler::node_key_interest) of each view, indexed by ViewType
+using key_mask_array = std::array<key_mask_type, view_type_count>;
 
 /**
  * The handler collection manages all handlers and calls their node, way, relation and area callbacks one
@@ -36,6 +47,8 @@ public:
     struct DatasetWithView {
         ViewType view;
         std::unique_ptr<gdalcpp::Dataset> dataset;
+        /// native writer of the dataset, nullptr if features are written using OGR
+        std::unique_ptr<SpatialiteWriter> native_writer;
         explicit DatasetWithView(ViewType v, std::unique_ptr<gdalcpp::Dataset>&& d);
     };
 
@@ -48,6 +61,17 @@ private:
 
     std::vector<std::unique_ptr<AbstractViewHandler>> m_handlers;
     PlacesHandler* m_places_handler = nullptr;
+
+    using static_handlers_type = std::tuple<GeometryViewHandler*, HighwayViewHandler*, SacScaleViewHandler*,
+          TaggingViewHandler*, PlacesHandler*>;
+
+    /// The handlers of m_handlers by their concrete type (nullptr if the view is not
+    /// produced). Calls via these pointers are not virtual and empty callbacks are compiled out.
+    static_handlers_type m_static_handlers {};
+
+    /// false if a view was added twice, the handlers are called via m_handlers then
+    bool m_static_dispatch = true;
+
     osmium::area::MultipolygonCollector<osmium::area::Assembler>::HandlerPass2* m_mp_collector_handler2 = nullptr;
     // Storing relation collectors holding GDAL layers as pointers
     // because they go out of scope before we rename the datasets they share with their node/way handlers.
@@ -55,6 +79,65 @@ private:
     AnyRelationCollector* any_relation_collector = nullptr;
     TurnRestrictionsManager* turn_restrictions_manager = nullptr;
 
+    /// If set, only ways in this set are passed to the handlers.
+    const id_set_type* m_way_filter = nullptr;
+
+    /// If set, only nodes in this set are passed to the handlers (but all to the relation managers).
+    const id_set_type* m_node_filter = nullptr;
+
+    /// writer of each layer used by the handlers if writer threads or the native SQLite
+    /// writer are enabled
+    layer_writer_map m_layer_writers;
+
+    /// native writer of each layer used by the writer threads
+    layer_writer_map m_native_layer_writers;
+
+    /// layers written by a writer thread or a native writer
+    std::vector<gdalcpp::Layer*> m_writer_layers;
+
+    /// fields of the layers in m_writer_layers, captured by open_writers
+    layer_fields_map m_layer_fields;
+
+    /// writer thread of each view (indexed by ViewType) if writer threads are enabled
+    // Declared after the datasets and handlers because the threads have to be stopped before
+    // the layers are destroyed.
+    std::array<std::unique_ptr<DatasetWriter>, view_type_count> m_view_writers;
+
+    /// digest of the tags of the current node or way shared by all handlers
+    TagDigest m_tag_digest;
+
+    /// digest of the tags of the current node or way of each view (indexed by ViewType) if
+    /// the views are processed by different threads (see apply_to_view)
+    std::array<TagDigest, view_type_count> m_view_digests;
+
+    /// union of the node key interests of the handlers of each view (indexed by ViewType),
+    /// see AbstractViewHandler::node_key_interest
+    key_mask_array m_node_interest {};
+
+    /// union of the way key interests of the handlers of each view (indexed by ViewType)
+    key_mask_array m_way_interest {};
+
+    /// m_way_interest without the views whose ways are passed in batches, used by way()
+    key_mask_array m_unbatched_way_interest {};
+
+    /// true for each view (indexed by ViewType) whose handler supports batches (see
+    /// AbstractViewHandler::supports_batches)
+    std::array<bool, view_type_count> m_batch_views {};
+
+    /// ways of the buffer processed by apply_buffer or apply_to_view for each view (indexed by ViewType)
+    std::array<WayBatch, view_type_count> m_view_batches;
+
+    /// views requested by the user, each one only once
+    std::vector<ViewType> m_views;
+
+    struct ViewTiming {
+        size_t objects = 0;
+        stats_clock::duration time {0};
+    };
+
+    /// time spent in the handlers of each view (indexed by ViewType), only measured if statistics are enabled
+    std::array<ViewTiming, view_type_count> m_view_timing;
+
     /**
      * Add a new dataset to the vector if the last one cannot be use for multiple layers
      */
@@ -76,6 +159,11 @@ private:
      */
     std::vector<std::string> close_datasets(const ViewType view_type);
 
+    /**
+     * Wait until the writer threads have written all features and stop them.
+     */
+    void finish_writers();
+
     void rename_output_files(const std::string& view_name, const std::vector<std::string>&& dataset_names);
 
     /**
@@ -102,6 +190,57 @@ private:
      */
     std::vector<std::string> get_gdal_default_layer_options();
 
+    /**
+     * Check if a location belongs to the shard processed by this process (see Options::shard_index).
+     *
+     * Shards are longitude bands of equal width.
+     */
+    bool in_shard(const osmium::Location& location) const;
+
+    /**
+     * Check if a way belongs to the shard processed by this process. A way belongs to the
+     * shard of its first node.
+     */
+    bool in_shard(const osmium::Way& way) const;
+
+    /**
+     * Make a handler available for the static dispatch of the node and way callbacks.
+     */
+    template <typename THandler>
+    void add_static_handler(THandler* handler) {
+        THandler*& slot = std::get<THandler*>(m_static_handlers);
+        if (slot) {
+            m_static_dispatch = false;
+        } else {
+            slot = handler;
+        }
+    }
+
+    void view_node(const ViewType view, const osmium::Node& node);
+
+    /**
+     * Pass a way to the handlers and relation managers of a view.
+     *
+     * \param batch If set and the handler of the view supports batches, the way is added to the
+     * batch instead of being passed to the handler. The relation managers get it immediately.
+     */
+    void view_way(const ViewType view, const osmium::Way& way, WayBatch* batch = nullptr);
+
+    /**
+     * Pass a batch of ways to the handlers of a view and clear it.
+     */
+    void view_way_batch(const ViewType view, WayBatch& batch);
+
+    void view_flush(const ViewType view);
+
+    bool collect_statistics() const noexcept {
+        return !m_options.stats_file.empty();
+    }
+
+    ViewTiming& view_timing(const ViewType view) {
+        return m_view_timing.at(static_cast<size_t>(view));
+    }
+
 public:
     HandlerCollection(Options& options);
 
@@ -110,9 +249,20 @@ public:
      * give it the name of the view.
      *
      * @arg view_name name of the view.
+     *
+     * \throws std::runtime_error if a writer thread failed or the spatial indexes cannot be built
      */
     void give_correct_name();
 
+    /**
+     * Prepare the native writers for writing and capture the fields of the layers written by
+     * writer threads or native writers. This method has to be called after all handlers and relation managers
+     * have been added and before any feature is written.
+     *
+     * \throws std::runtime_error
+     */
+    void open_writers();
+
     /**
      * \brief Create and register a new handler.
      *
@@ -133,8 +283,58 @@ public:
      */
     void add_multipolygon_collector(osmium::area::MultipolygonCollector<osmium::area::Assembler>& collector);
 
+    /**
+     * Only pass ways whose ID is in the provided set to the handlers and relation managers.
+     *
+     * \param filter set of way IDs or nullptr to disable filtering
+     */
+    void set_way_filter(const id_set_type* filter);
+
+    /**
+     * Only pass nodes whose ID is in the provided set to the handlers. Relation managers still
+     * get all nodes.
+     *
+     * \param filter set of node IDs or nullptr to disable filtering
+     */
+    void set_node_filter(const id_set_type* filter);
+
+    /**
+     * Check if a way will produce output in any view. Node locations are not required.
+     *
+     * Ways which are needed by relation managers are not taken into account. Use
+     * add_relation_member_ways for them.
+     */
+    bool way_produces_output(const osmium::Way& way);
+
+    /**
+     * Check if the output of all views depends on ways with certain keys and relation
+     * members only.
+     */
+    bool limited_by_keys() const;
+
+    /**
+     * Check if a way has any key relevant for any of the views.
+     *
+     * Ways which are needed by relation managers are not taken into account. Use
+     * add_relation_member_ways for them.
+     */
+    bool way_has_relevant_keys(const osmium::Way& way) const;
+
+    /**
+     * Add the IDs of all way members of the relations collected by the relation managers.
+     *
+     * This method may only be called after the first pass.
+     */
+    void add_relation_member_ways(id_set_type& ids);
+
     void node(const osmium::Node& node);
 
+    /**
+     * Pass a way to the handlers and relation managers of all views.
+     *
+     * Ways for handlers supporting batches are collected and passed to them in flush(). Therefore
+     * flush() has to be called before the buffer holding the way is released.
+     */
     void way(const osmium::Way& way);
 
     void relation(const osmium::Relation& relation);
@@ -142,6 +342,37 @@ public:
     void area(const osmium::Area& area);
 
     void flush();
+
+    /**
+     * Add the statistics of all views to the run statistics.
+     *
+     * Times are only available if statistics were enabled before the main pass.
+     */
+    void add_statistics(RunStatistics& statistics) const;
+
+    /**
+     * Print the counters of the individual checks of all views.
+     */
+    void print_check_counters(std::ostream& out) const;
+
+    /**
+     * \brief Feed all nodes and ways of a buffer to the handlers and relation managers of all
+     * views.
+     *
+     * If statistics are enabled, the time is measured once per buffer. With more than one view
+     * the buffer is passed to one view after another (see apply_to_view) to measure the time
+     * of each view.
+     */
+    void apply_buffer(const osmium::memory::Buffer& buffer);
+
+    /**
+     * \brief Feed all nodes and ways of a buffer to the handlers and relation managers
+     * belonging to one view.
+     *
+     * Handlers of different views do not share any state. Therefore this method may be called
+     * for different views from different threads at the same time.
+     */
+    void apply_to_view(const ViewType view, const osmium::memory::Buffer& buffer);
 };
 
 
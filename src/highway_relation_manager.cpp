@@ -16,8 +16,16 @@ void HighwayRelationManager::enable() {
     enabled = true;
 }
 
+void HighwayRelationManager::set_relation_filter(const id_set_type* filter) {
+    relation_filter = filter;
+}
+
 bool HighwayRelationManager::new_relation(const osmium::Relation& relation) const noexcept {
-    if (!enabled) {
+    if (!enabled || (relation_filter && !relation_filter->get(relation.positive_id()))) {
+        return false;
+    }
+    // Relations are distributed over the shards by their ID.
+    if (m_options.shard_count > 1 && relation.positive_id() % m_options.shard_count != m_options.shard_index) {
         return false;
     }
     const char* highway = relation.tags().get_value_by_key("highway");
@@ -61,9 +69,9 @@ void HighwayRelationManager::process_relation(const osmium::Relation& relation)
         }
     }
     std::unique_ptr<OGRGeometry> geom {static_cast<OGRGeometry*>(ml.release())};
-    gdalcpp::Feature feature(*(m_relations_with_highway.get()), std::move(geom));
+    OutputFeature feature(*(m_relations_with_highway.get()), std::move(geom));
     TaggingViewHandler::set_basic_fields(feature, relation, "highway", relation.tags().get_value_by_key("highway"));
-    feature.add_to_layer();
+    write_feature(feature);
 }
 
 void HighwayRelationManager::create_layer(CreateLayerFunc func) {
@@ -11,6 +11,7 @@
 #include <gdalcpp.hpp>
 #include <osmium/relations/relations_manager.hpp>
 #include "ogr_output_base.hpp"
+#include "selective_node_locations.hpp"
 
 class HighwayRelationManager : public osmium::relations::RelationsManager<HighwayRelationManager,
 false, true, false>, public OGROutputBase {
@@ -19,6 +20,9 @@ false, true, false>, public OGROutputBase {
 
     bool enabled;
 
+    /// If set, only relations whose ID is in this set are collected.
+    const id_set_type* relation_filter = nullptr;
+
 public:
     HighwayRelationManager() = delete;
 
@@ -34,6 +38,13 @@ public:
      */
     void enable();
 
+    /**
+     * Collect only relations whose ID is in the provided set.
+     *
+     * This method has to be called before the first pass.
+     */
+    void set_relation_filter(const id_set_type* filter);
+
     /**
      * This method decides which relations we're interested in, and
      * instructs Osmium to collect their members for us.
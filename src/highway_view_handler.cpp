@@ -19,6 +19,7 @@
 
 
 #include "highway_view_handler.hpp"
+#include "tag_digest.hpp"
 #include <limits>
 
 
@@ -113,12 +114,44 @@ HighwayViewHandler::HighwayViewHandler(Options& options, CreateLayerFunc create_
     register_check(name_missing_minor, "highway", m_highway_name_missing_minor.get());
     register_check(highway_road, "", m_highway_road.get());
     register_check(highway_long_ref, "ref", m_highway_long_ref.get());
+    m_lanes_counter = m_check_counters.add("check_lanes_tags");
+    m_lifecycle_counter = m_check_counters.add("highway_multiple_lifecycle_states");
 }
 
 ViewType HighwayViewHandler::view_type() const {
     return ViewType::highways;
 }
 
+bool HighwayViewHandler::limited_by_keys() const {
+    return true;
+}
+
+bool HighwayViewHandler::way_has_relevant_keys(const osmium::Way& way) const {
+    const osmium::TagList& tags = way.tags();
+    return TagDigest::value(tags, TagKey::highway) || TagDigest::value(tags, TagKey::abandoned_highway)
+            || TagDigest::value(tags, TagKey::disused_highway)
+            || TagDigest::value(tags, TagKey::construction_highway)
+            || TagDigest::value(tags, TagKey::proposed_highway);
+}
+
+key_mask_type HighwayViewHandler::node_key_interest() const {
+    return key_bit(TagKey::highway);
+}
+
+key_mask_type HighwayViewHandler::way_key_interest() const {
+    // same keys as way_has_relevant_keys
+    return key_bit(TagKey::highway) | key_bit(TagKey::abandoned_highway) | key_bit(TagKey::disused_highway)
+        | key_bit(TagKey::construction_highway) | key_bit(TagKey::proposed_highway);
+}
+
+bool HighwayViewHandler::supports_batches() const {
+    return true;
+}
+
+bool HighwayViewHandler::supports_selection() const {
+    return true;
+}
+
 std::string HighwayViewHandler::view_name() const {
     return "highways";
 }
@@ -148,6 +181,8 @@ void HighwayViewHandler::register_check(std::function<bool (const osmium::TagLis
     m_checks.push_back(function);
     m_keys.push_back(key);
     m_layers.push_back(layer);
+    // The index of the counter is the index of the check.
+    m_check_counters.add(layer->name());
 }
 
 bool HighwayViewHandler::is_valid_const_speed(const char* maxspeed_value) {
@@ -224,7 +259,7 @@ bool HighwayViewHandler::is_valid_const_speed(const char* maxspeed_value) {
 }
 
 void HighwayViewHandler::set_fields(gdalcpp::Layer* layer, const osmium::Way& way, const char* third_field_name,
-        const char* third_field_value, std::string& other_tags) {
+        const char* third_field_value, const char* other_tags) {
     set_fields<osmium::Way>(
             layer, way, third_field_name, third_field_value, other_tags,
             [](const osmium::Way& way, ogr_factory_type& factory) {return factory.create_linestring(way);},
@@ -233,18 +268,18 @@ void HighwayViewHandler::set_fields(gdalcpp::Layer* layer, const osmium::Way& wa
 }
 
 int HighwayViewHandler::check_lanes_value_and_write_error(const osmium::Way& way, const char* key) {
-    const char* lanes_value = way.get_value_by_key(key);
+    const char* lanes_value = TagDigest::value(way.tags(), key);
     if (!lanes_value) {
         return 0;
     }
     char* rest;
     long int lanes_read = std::strtol(lanes_value, &rest, 10);
     if (*rest || lanes_read <= 0 || lanes_read > 16) {
-        std::string tags_str = tags_string(way.tags(), "lanes");
+        const char* tags_str = tags_string(way.tags(), "lanes");
         std::string error_msg = "invalid number ";
         error_msg += key;
         set_fields<osmium::Way>(
-                m_highway_lanes.get(), way, "lanes", way.get_value_by_key("lanes", ""), tags_str,
+                m_highway_lanes.get(), way, "lanes", TagDigest::value(way.tags(), TagKey::lanes, ""), tags_str,
                 [](const osmium::Way& way, ogr_factory_type& factory) {return factory.create_linestring(way);},
                 way.id(), "way_id", "error", error_msg.c_str()
         );
@@ -254,8 +289,8 @@ int HighwayViewHandler::check_lanes_value_and_write_error(const osmium::Way& way
 }
 
 bool HighwayViewHandler::all_oneway(const osmium::TagList& tags) {
-    const char* oneway = tags.get_value_by_key("oneway");
-    const char* junction = tags.get_value_by_key("junction");
+    const char* oneway = TagDigest::value(tags, TagKey::oneway);
+    const char* junction = TagDigest::value(tags, TagKey::junction);
     if ((!oneway || strcmp(oneway, "yes")) && (!junction || strcmp(junction, "roundabout"))) {
         return false;
     }
@@ -338,13 +373,13 @@ bool HighwayViewHandler::check_valid_turns(const char* turns) {
 
 int HighwayViewHandler::get_cycleway_lane_count(const osmium::TagList& tags) {
     int lanes = 0;
-    const char* cycleway = tags.get_value_by_key("cycleway");
-    const char* cycleway_both = tags.get_value_by_key("cycleway");
+    const char* cycleway = TagDigest::value(tags, TagKey::cycleway);
+    const char* cycleway_both = TagDigest::value(tags, TagKey::cycleway);
     if ((cycleway && !strcmp(cycleway, "lane")) || (cycleway_both && !strcmp(cycleway_both, "lane"))) {
         return 2;
     } else {
-        const char* cycleway_right = tags.get_value_by_key("cycleway:right");
-        const char* cycleway_left = tags.get_value_by_key("cycleway:left");
+        const char* cycleway_right = TagDigest::value(tags, TagKey::cycleway_right);
+        const char* cycleway_left = TagDigest::value(tags, TagKey::cycleway_left);
         if (cycleway_right && !strcmp(cycleway_right, "lane")) {
             ++lanes;
         } else if (cycleway_left && !strcmp(cycleway_left, "lane")) {
@@ -376,7 +411,7 @@ void HighwayViewHandler::check_lanes_tags(const osmium::Way& way) {
     int lanes_tag_count = static_cast<int>(lanes_fwd > 0) + static_cast<int>(lanes_bkwd > 0) + static_cast<int>(lanes_both > 0);
     // lanes:forward=*, lanes:backward=* and lanes:both_ways=* without lanes=*
     if (lanes_tag_count > 1 && lanes == 0) {
-        std::string tags_str = selective_tags_str<3>(way.tags(), '|', {"lanes:forward", "lanes:backward", "lanes:both_ways"});
+        const char* tags_str = selective_tags_str<3>(way.tags(), '|', {"lanes:forward", "lanes:backward", "lanes:both_ways"});
         set_fields<osmium::Way>(
                 m_highway_lanes.get(), way, "lanes", "NOT SET", tags_str,
                 [](const osmium::Way& way, ogr_factory_type& factory) {return factory.create_linestring(way);},
@@ -386,9 +421,9 @@ void HighwayViewHandler::check_lanes_tags(const osmium::Way& way) {
     }
     // check if the values make sense at all
     if (lanes_tag_count > 1 && lanes != lanes_sum) {
-        std::string tags_str = selective_tags_str<3>(way.tags(), '|', {"lanes:forward", "lanes:backward", "lanes:both_ways"});
+        const char* tags_str = selective_tags_str<3>(way.tags(), '|', {"lanes:forward", "lanes:backward", "lanes:both_ways"});
         set_fields<osmium::Way>(
-                m_highway_lanes.get(), way, "lanes", way.get_value_by_key("lanes", ""), tags_str,
+                m_highway_lanes.get(), way, "lanes", TagDigest::value(way.tags(), TagKey::lanes, ""), tags_str,
                 [](const osmium::Way& way, ogr_factory_type& factory) {return factory.create_linestring(way);},
                 way.id(), "way_id", "error", "forward+backward+both_ways != both"
         );
@@ -396,9 +431,9 @@ void HighwayViewHandler::check_lanes_tags(const osmium::Way& way) {
     }
     // If any lanes:*=* is present, warn if lanes=* is missing
     if (lanes != lanes_sum && lanes_sum > 0) {
-        std::string tags_str = selective_tags_str<3>(way.tags(), '|', {"lanes:forward", "lanes:backward", "lanes:both_ways"});
+        const char* tags_str = selective_tags_str<3>(way.tags(), '|', {"lanes:forward", "lanes:backward", "lanes:both_ways"});
         set_fields<osmium::Way>(
-                m_highway_lanes.get(), way, "lanes", way.get_value_by_key("lanes", ""), tags_str,
+                m_highway_lanes.get(), way, "lanes", TagDigest::value(way.tags(), TagKey::lanes, ""), tags_str,
                 [](const osmium::Way& way, ogr_factory_type& factory) {return factory.create_linestring(way);},
                 way.id(), "way_id", "error", "lanes:forward=*, lanes:backward=* or lanes:both_ways=* without lanes=*"
         );
@@ -407,28 +442,28 @@ void HighwayViewHandler::check_lanes_tags(const osmium::Way& way) {
     // direction values on oneways
     bool pure_oneway = all_oneway(way.tags());
     if ((lanes_tag_count > 0) && pure_oneway) {
-        std::string tags_str = selective_tags_str<4>(way.tags(), '|', {"lanes:forward", "lanes:backward", "lanes:both_ways", "oneway"});
+        const char* tags_str = selective_tags_str<4>(way.tags(), '|', {"lanes:forward", "lanes:backward", "lanes:both_ways", "oneway"});
         set_fields<osmium::Way>(
-                m_highway_lanes.get(), way, "lanes", way.get_value_by_key("lanes", ""), tags_str,
+                m_highway_lanes.get(), way, "lanes", TagDigest::value(way.tags(), TagKey::lanes, ""), tags_str,
                 [](const osmium::Way& way, ogr_factory_type& factory) {return factory.create_linestring(way);},
                 way.id(), "way_id", "error", "direction dependent value given although road is oneway"
         );
         return;
     }
     // check if turn:lanes is present on bidirectional ways
-    std::string all_tags_str = tags_string(way.tags(), "highway");
-    if (way.tags().has_key("turn:lanes") && !pure_oneway) {
+    const char* all_tags_str = tags_string(way.tags(), "highway");
+    if (TagDigest::value(way.tags(), TagKey::turn_lanes) && !pure_oneway) {
         set_fields<osmium::Way>(
-                m_highway_lanes.get(), way, "lanes", way.get_value_by_key("lanes", ""), all_tags_str,
+                m_highway_lanes.get(), way, "lanes", TagDigest::value(way.tags(), TagKey::lanes, ""), all_tags_str,
                 [](const osmium::Way& way, ogr_factory_type& factory) {return factory.create_linestring(way);},
                 way.id(), "way_id", "error", "turn:lanes on bidirectional way"
         );
         return;
     }
-    const char* turn_lanes_both_ways = way.get_value_by_key("turn:lanes:both_ways");
+    const char* turn_lanes_both_ways = TagDigest::value(way.tags(), TagKey::turn_lanes_both_ways);
     if (turn_lanes_both_ways && !lanes_both) {
         set_fields<osmium::Way>(
-                m_highway_lanes.get(), way, "lanes", way.get_value_by_key("lanes", ""), all_tags_str,
+                m_highway_lanes.get(), way, "lanes", TagDigest::value(way.tags(), TagKey::lanes, ""), all_tags_str,
                 [](const osmium::Way& way, ogr_factory_type& factory) {return factory.create_linestring(way);},
                 way.id(), "way_id", "error", "turn:lanes:both_ways without turn:lanes"
         );
@@ -437,16 +472,17 @@ void HighwayViewHandler::check_lanes_tags(const osmium::Way& way) {
     int turn_lanes_count_both = pipe_separated_items_count(turn_lanes_both_ways);
     if (turn_lanes_count_both > 0 && turn_lanes_count_both < lanes_both) {
         set_fields<osmium::Way>(
-                m_highway_lanes.get(), way, "lanes", way.get_value_by_key("lanes", ""), all_tags_str,
+                m_highway_lanes.get(), way, "lanes", TagDigest::value(way.tags(), TagKey::lanes, ""), all_tags_str,
                 [](const osmium::Way& way, ogr_factory_type& factory) {return factory.create_linestring(way);},
                 way.id(), "way_id", "error", "turn:lanes:both_ways contains too few lanes"
         );
         return;
     }
-    if ((way.tags().has_key("turn:lanes:forward") || way.tags().has_key("turn:lanes:backward")
+    if ((TagDigest::value(way.tags(), TagKey::turn_lanes_forward)
+            || TagDigest::value(way.tags(), TagKey::turn_lanes_backward)
             || turn_lanes_both_ways) && pure_oneway) {
         set_fields<osmium::Way>(
-                m_highway_lanes.get(), way, "lanes", way.get_value_by_key("lanes", ""), all_tags_str,
+                m_highway_lanes.get(), way, "lanes", TagDigest::value(way.tags(), TagKey::lanes, ""), all_tags_str,
                 [](const osmium::Way& way, ogr_factory_type& factory) {return factory.create_linestring(way);},
                 way.id(), "way_id", "error", "unneccessary direction-dependent turn:lanes on oneway"
         );
@@ -454,11 +490,11 @@ void HighwayViewHandler::check_lanes_tags(const osmium::Way& way) {
     }
     int cycleway_lanes = get_cycleway_lane_count(way.tags());
     // number of lanes vs. turn:lanes
-    const char* turn_lanes_value = way.get_value_by_key("turn:lanes");
+    const char* turn_lanes_value = TagDigest::value(way.tags(), TagKey::turn_lanes);
     int turn_lanes_count = pipe_separated_items_count(turn_lanes_value);
     if (turn_lanes_count > 0 && lanes == 0) {
         set_fields<osmium::Way>(
-                m_highway_lanes.get(), way, "lanes", way.get_value_by_key("lanes", ""), all_tags_str,
+                m_highway_lanes.get(), way, "lanes", TagDigest::value(way.tags(), TagKey::lanes, ""), all_tags_str,
                 [](const osmium::Way& way, ogr_factory_type& factory) {return factory.create_linestring(way);},
                 way.id(), "way_id", "error", "turn:lanes without lanes=*"
         );
@@ -466,7 +502,7 @@ void HighwayViewHandler::check_lanes_tags(const osmium::Way& way) {
     }
     if (turn_lanes_count > 0 && turn_lanes_count < lanes + cycleway_lanes) {
         set_fields<osmium::Way>(
-                m_highway_lanes.get(), way, "lanes", way.get_value_by_key("lanes", ""), all_tags_str,
+                m_highway_lanes.get(), way, "lanes", TagDigest::value(way.tags(), TagKey::lanes, ""), all_tags_str,
                 [](const osmium::Way& way, ogr_factory_type& factory) {return factory.create_linestring(way);},
                 way.id(), "way_id", "error", "turn:lanes contains too few lanes"
         );
@@ -474,18 +510,18 @@ void HighwayViewHandler::check_lanes_tags(const osmium::Way& way) {
     }
     if (!check_valid_turns(turn_lanes_value)) {
         set_fields<osmium::Way>(
-                m_highway_lanes.get(), way, "lanes", way.get_value_by_key("lanes", ""), all_tags_str,
+                m_highway_lanes.get(), way, "lanes", TagDigest::value(way.tags(), TagKey::lanes, ""), all_tags_str,
                 [](const osmium::Way& way, ogr_factory_type& factory) {return factory.create_linestring(way);},
                 way.id(), "way_id", "error", "turn:lanes contains invalid directions"
         );
         return;
     }
     // forward
-    const char* turn_lanes_value_fwd = way.get_value_by_key("turn:lanes:forward");
+    const char* turn_lanes_value_fwd = TagDigest::value(way.tags(), TagKey::turn_lanes_forward);
     int turn_lanes_count_fwd = pipe_separated_items_count(turn_lanes_value_fwd);
     if (turn_lanes_count_fwd > 0 && lanes_fwd == 0) {
         set_fields<osmium::Way>(
-                m_highway_lanes.get(), way, "lanes", way.get_value_by_key("lanes", ""), all_tags_str,
+                m_highway_lanes.get(), way, "lanes", TagDigest::value(way.tags(), TagKey::lanes, ""), all_tags_str,
                 [](const osmium::Way& way, ogr_factory_type& factory) {return factory.create_linestring(way);},
                 way.id(), "way_id", "error", "turn:lanes:forward without lanes:forward=*"
         );
@@ -493,7 +529,7 @@ void HighwayViewHandler::check_lanes_tags(const osmium::Way& way) {
     }
     if (turn_lanes_count_fwd > 0 && turn_lanes_count_fwd < lanes_fwd) {
         set_fields<osmium::Way>(
-                m_highway_lanes.get(), way, "lanes", way.get_value_by_key("lanes", ""), all_tags_str,
+                m_highway_lanes.get(), way, "lanes", TagDigest::value(way.tags(), TagKey::lanes, ""), all_tags_str,
                 [](const osmium::Way& way, ogr_factory_type& factory) {return factory.create_linestring(way);},
                 way.id(), "way_id", "error", "turn:lanes:forward contains too few lanes"
         );
@@ -501,18 +537,18 @@ void HighwayViewHandler::check_lanes_tags(const osmium::Way& way) {
     }
     if (!check_valid_turns(turn_lanes_value_fwd)) {
         set_fields<osmium::Way>(
-                m_highway_lanes.get(), way, "lanes", way.get_value_by_key("lanes", ""), all_tags_str,
+                m_highway_lanes.get(), way, "lanes", TagDigest::value(way.tags(), TagKey::lanes, ""), all_tags_str,
                 [](const osmium::Way& way, ogr_factory_type& factory) {return factory.create_linestring(way);},
                 way.id(), "way_id", "error", "turn:lanes:forward contains invalid directions"
         );
         return;
     }
     // backward
-    const char* turn_lanes_value_bkwd = way.get_value_by_key("turn:lanes:backward");
+    const char* turn_lanes_value_bkwd = TagDigest::value(way.tags(), TagKey::turn_lanes_backward);
     int turn_lanes_count_bkwd = pipe_separated_items_count(turn_lanes_value_bkwd);
     if (turn_lanes_count_bkwd > 0 && lanes_bkwd == 0) {
         set_fields<osmium::Way>(
-                m_highway_lanes.get(), way, "lanes", way.get_value_by_key("lanes", ""), all_tags_str,
+                m_highway_lanes.get(), way, "lanes", TagDigest::value(way.tags(), TagKey::lanes, ""), all_tags_str,
                 [](const osmium::Way& way, ogr_factory_type& factory) {return factory.create_linestring(way);},
                 way.id(), "way_id", "error", "turn:lanes:backward without lanes:backward=*"
         );
@@ -520,7 +556,7 @@ void HighwayViewHandler::check_lanes_tags(const osmium::Way& way) {
     }
     if (turn_lanes_count_bkwd > 0 && turn_lanes_count_bkwd < lanes_bkwd) {
         set_fields<osmium::Way>(
-                m_highway_lanes.get(), way, "lanes", way.get_value_by_key("lanes", ""), all_tags_str,
+                m_highway_lanes.get(), way, "lanes", TagDigest::value(way.tags(), TagKey::lanes, ""), all_tags_str,
                 [](const osmium::Way& way, ogr_factory_type& factory) {return factory.create_linestring(way);},
                 way.id(), "way_id", "error", "turn:lanes:backward contains too few lanes"
         );
@@ -528,7 +564,7 @@ void HighwayViewHandler::check_lanes_tags(const osmium::Way& way) {
     }
     if (!check_valid_turns(turn_lanes_value_bkwd)) {
         set_fields<osmium::Way>(
-                m_highway_lanes.get(), way, "lanes", way.get_value_by_key("lanes", ""), all_tags_str,
+                m_highway_lanes.get(), way, "lanes", TagDigest::value(way.tags(), TagKey::lanes, ""), all_tags_str,
                 [](const osmium::Way& way, ogr_factory_type& factory) {return factory.create_linestring(way);},
                 way.id(), "way_id", "error", "turn:lanes:backward contains invalid directions"
         );
@@ -543,7 +579,7 @@ void HighwayViewHandler::check_lanes_tags(const osmium::Way& way) {
             || (turn_lanes_count_fwd && turn_lanes_count_bkwd
                     && turn_lanes_count_both + turn_lanes_count_fwd + turn_lanes_count_bkwd < lanes + cycleway_lanes)) {
         set_fields<osmium::Way>(
-                m_highway_lanes.get(), way, "lanes", way.get_value_by_key("lanes", ""), all_tags_str,
+                m_highway_lanes.get(), way, "lanes", TagDigest::value(way.tags(), TagKey::lanes, ""), all_tags_str,
                 [](const osmium::Way& way, ogr_factory_type& factory) {return factory.create_linestring(way);},
                 way.id(), "way_id", "error", "turn lanes must include cycleway lanes"
         );
@@ -552,7 +588,7 @@ void HighwayViewHandler::check_lanes_tags(const osmium::Way& way) {
 }
 
 bool HighwayViewHandler::name_not_fixme(const osmium::TagList& tags) {
-    const char* name_value = tags.get_value_by_key("name");
+    const char* name_value = TagDigest::value(tags, TagKey::name);
     if (!name_value) {
         return true;
     }
@@ -567,7 +603,7 @@ bool HighwayViewHandler::name_not_fixme(const osmium::TagList& tags) {
 }
 
 bool HighwayViewHandler::oneway_ok(const osmium::TagList& tags) {
-    const char* oneway_value = tags.get_value_by_key("oneway");
+    const char* oneway_value = TagDigest::value(tags, TagKey::oneway);
     return check_oneway(oneway_value);
 }
 
@@ -582,7 +618,7 @@ bool HighwayViewHandler::check_oneway(const char* oneway_value) {
 }
 
 bool HighwayViewHandler::maxspeed_ok(const osmium::TagList& tags) {
-    const char* maxspeed_value = tags.get_value_by_key("maxspeed");
+    const char* maxspeed_value = TagDigest::value(tags, TagKey::maxspeed);
     if (!maxspeed_value) {
         return true;
     }
@@ -642,7 +678,7 @@ bool HighwayViewHandler::check_length_value(const char* value) {
 }
 
 bool HighwayViewHandler::maxheight_ok(const osmium::TagList& tags) {
-    const char* maxheight_value = tags.get_value_by_key("maxheight");
+    const char* maxheight_value = TagDigest::value(tags, TagKey::maxheight);
     // There are a couple of valid non-numeric maxheight values.
     if (maxheight_value && (
         !strcmp(maxheight_value, "none")
@@ -654,12 +690,12 @@ bool HighwayViewHandler::maxheight_ok(const osmium::TagList& tags) {
 }
 
 bool HighwayViewHandler::maxlength_ok(const osmium::TagList& tags) {
-    const char* maxlength_value = tags.get_value_by_key("maxlength");
+    const char* maxlength_value = TagDigest::value(tags, TagKey::maxlength);
     return check_length_value(maxlength_value);
 }
 
 bool HighwayViewHandler::maxweight_ok(const osmium::TagList& tags) {
-    const char* maxweight_value = tags.get_value_by_key("maxweight");
+    const char* maxweight_value = TagDigest::value(tags, TagKey::maxweight);
     return check_maxweight(maxweight_value);
 }
 
@@ -699,17 +735,17 @@ bool HighwayViewHandler::check_maxweight(const char* maxweight_value) {
 
 
 bool HighwayViewHandler::name_missing_major(const osmium::TagList& tags) {
-    const char* name = tags.get_value_by_key("name");
-    const char* ref = tags.get_value_by_key("ref");
-    const char* noname = tags.get_value_by_key("noname");
+    const char* name = TagDigest::value(tags, TagKey::name);
+    const char* ref = TagDigest::value(tags, TagKey::ref);
+    const char* noname = TagDigest::value(tags, TagKey::noname);
     if (name || ref || (noname && !strcmp(noname, "yes"))) {
         return true;
     }
-    const char* junction = tags.get_value_by_key("junction");
+    const char* junction = TagDigest::value(tags, TagKey::junction);
     if (junction && (!strcmp(junction, "roundabout") || !strcmp(junction, "round"))) {
         return true;
     }
-    const char* highway = tags.get_value_by_key("highway");
+    const char* highway = TagDigest::value(tags, TagKey::highway);
     if (strcmp(highway, "motorway") != 0 && strcmp(highway, "trunk") != 0 && strcmp(highway, "primary") != 0
             && strcmp(highway, "secondary") != 0 && strcmp(highway, "tertiary") != 0) {
         return true;
@@ -718,14 +754,14 @@ bool HighwayViewHandler::name_missing_major(const osmium::TagList& tags) {
 }
 
 bool HighwayViewHandler::name_missing_minor(const osmium::TagList& tags) {
-    const char* tiger_reviewed = tags.get_value_by_key("tiger:reviewed");
-    const char* name = tags.get_value_by_key("name");
-    const char* ref = tags.get_value_by_key("ref");
-    const char* noname = tags.get_value_by_key("noname");
+    const char* tiger_reviewed = TagDigest::value(tags, TagKey::tiger_reviewed);
+    const char* name = TagDigest::value(tags, TagKey::name);
+    const char* ref = TagDigest::value(tags, TagKey::ref);
+    const char* noname = TagDigest::value(tags, TagKey::noname);
     if (name || ref || (noname && !strcmp(noname, "yes"))) {
         return true;
     }
-    const char* junction = tags.get_value_by_key("junction");
+    const char* junction = TagDigest::value(tags, TagKey::junction);
     if (junction && (!strcmp(junction, "roundabout") || !strcmp(junction, "round"))) {
         return true;
     }
@@ -733,7 +769,7 @@ bool HighwayViewHandler::name_missing_minor(const osmium::TagList& tags) {
     if (tiger_reviewed && !strcmp(tiger_reviewed, "no")) {
         return true;
     }
-    const char* highway = tags.get_value_by_key("highway");
+    const char* highway = TagDigest::value(tags, TagKey::highway);
     if (strcmp(highway, "residential") != 0 && strcmp(highway, "living_street") != 0 && strcmp(highway, "pedestrian") != 0) {
         return true;
     }
@@ -741,7 +777,7 @@ bool HighwayViewHandler::name_missing_minor(const osmium::TagList& tags) {
 }
 
 bool HighwayViewHandler::highway_road(const osmium::TagList& tags) {
-    const char* highway = tags.get_value_by_key("highway");
+    const char* highway = TagDigest::value(tags, TagKey::highway);
     if (highway && !strcmp(highway, "road")) {
         return false;
     }
@@ -749,7 +785,7 @@ bool HighwayViewHandler::highway_road(const osmium::TagList& tags) {
 }
 
 bool HighwayViewHandler::highway_long_ref(const osmium::TagList& tags) {
-    const char* ref = tags.get_value_by_key("ref");
+    const char* ref = TagDigest::value(tags, TagKey::ref);
     if (!ref) {
         return true;
     }
@@ -764,14 +800,14 @@ bool HighwayViewHandler::highway_long_ref(const osmium::TagList& tags) {
 }
 
 void HighwayViewHandler::ways_with_key(const osmium::Way& way, gdalcpp::Layer* layer, const char* key, const char* alternative_key) {
-    const char* value = way.get_value_by_key(key);
+    const char* value = TagDigest::value(way.tags(), key);
     const char* found_key = key;
     if (!value && alternative_key) {
-        value = way.get_value_by_key(alternative_key);
+        value = TagDigest::value(way.tags(), alternative_key);
         found_key = alternative_key;
     }
     if (value) {
-        std::string tags_str = tags_string(way.tags(), found_key);
+        const char* tags_str = tags_string(way.tags(), found_key);
         set_fields<osmium::Way>(layer, way, key, value, tags_str,
                 [](const osmium::Way& way, ogr_factory_type& factory) {return factory.create_linestring(way);},
                 way.id(), "way_id");
@@ -779,7 +815,7 @@ void HighwayViewHandler::ways_with_key(const osmium::Way& way, gdalcpp::Layer* l
 }
 
 void HighwayViewHandler::highway_unknown_node(const osmium::Node& node) {
-    const char* highway = node.get_value_by_key("highway");
+    const char* highway = TagDigest::value(node.tags(), TagKey::highway);
     if (!highway) {
         return;
     }
@@ -799,14 +835,14 @@ void HighwayViewHandler::highway_unknown_node(const osmium::Node& node) {
             || !strcmp(highway, "trailhead")) {
         return;
     }
-    std::string tags_str = tags_string(node.tags(), "highway");
+    const char* tags_str = tags_string(node.tags(), "highway");
     set_fields<osmium::Node>(m_highway_unknown_node.get(), node, "highway", highway, tags_str,
             [](const osmium::Node& node, ogr_factory_type& factory) {return factory.create_point(node);},
             node.id(), "node_id");
 }
 
 void HighwayViewHandler::highway_unknown_way(const osmium::Way& way) {
-    const char* highway = way.get_value_by_key("highway");
+    const char* highway = TagDigest::value(way.tags(), TagKey::highway);
     if (!highway) {
         return;
     }
@@ -828,26 +864,26 @@ void HighwayViewHandler::highway_unknown_way(const osmium::Way& way) {
     if (way.is_closed() && (!strcmp(highway, "services") || !strcmp(highway, "rest_area") || !strcmp(highway, "traffic_island"))) {
         return;
     }
-    std::string tags_str = tags_string(way.tags(), "highway");
+    const char* tags_str = tags_string(way.tags(), "highway");
     set_fields<osmium::Way>(m_highway_unknown_way.get(), way, "highway", highway, tags_str,
             [](const osmium::Way& way, ogr_factory_type& factory) {return factory.create_linestring(way);},
             way.id(), "way_id");
 }
 
 void HighwayViewHandler::highway_multiple_lifecycle_states(const osmium::Way& way) {
-    const char* disused = way.get_value_by_key("disused");
-    const char* disused_highway = way.get_value_by_key("disused:highway");
-    const char* abandoned = way.get_value_by_key("abandoned");
-    const char* abandoned_highway = way.get_value_by_key("abandoned:highway");
-    const char* proposed = way.get_value_by_key("proposed");
-    const char* proposed_highway = way.get_value_by_key("proposed:highway");
-    const char* construction = way.get_value_by_key("construction");
+    const char* disused = TagDigest::value(way.tags(), TagKey::disused);
+    const char* disused_highway = TagDigest::value(way.tags(), TagKey::disused_highway);
+    const char* abandoned = TagDigest::value(way.tags(), TagKey::abandoned);
+    const char* abandoned_highway = TagDigest::value(way.tags(), TagKey::abandoned_highway);
+    const char* proposed = TagDigest::value(way.tags(), TagKey::proposed);
+    const char* proposed_highway = TagDigest::value(way.tags(), TagKey::proposed_highway);
+    const char* construction = TagDigest::value(way.tags(), TagKey::construction);
     // special handling for construction=minor which is a valid tag for highways in use
     if (construction && !strcmp(construction, "minor")) {
         construction = nullptr;
     }
-    const char* construction_highway = way.get_value_by_key("construction:highway");
-    const char* highway = way.get_value_by_key("highway");
+    const char* construction_highway = TagDigest::value(way.tags(), TagKey::construction_highway);
+    const char* highway = TagDigest::value(way.tags(), TagKey::highway);
     constexpr size_t number = 5;
     if (!disused) {
         disused = disused_highway;
@@ -876,7 +912,7 @@ void HighwayViewHandler::highway_multiple_lifecycle_states(const osmium::Way& wa
                 // On of the previous keys had a value as well. Therefore, the ways has two lifecycle states.
                 // If any out-of-life (abandoned/disused/construction/proposed) and highway is set,
                 // we ensure that a present highway=* is not set to the key of the previous state.
-                std::string tags_str = tags_string(way.tags(), nullptr);
+                const char* tags_str = tags_string(way.tags(), nullptr);
                 std::string error_msg {keys.at(last_found_key_idx)};
                 error_msg.push_back('+');
                 error_msg.append(key);
@@ -899,7 +935,7 @@ void HighwayViewHandler::highway_multiple_lifecycle_states(const osmium::Way& wa
             }
         }
         if (missing_nonop_key) {
-            std::string tags_str = tags_string(way.tags(), "highway");
+            const char* tags_str = tags_string(way.tags(), "highway");
             std::string error_msg = "highway=";
             error_msg.append(missing_nonop_key);
             error_msg.append(" without ");
@@ -912,25 +948,82 @@ void HighwayViewHandler::highway_multiple_lifecycle_states(const osmium::Way& wa
     }
 }
 
+void HighwayViewHandler::write_check_failure(const size_t index, const osmium::Way& way) {
+    const char* tags_str = tags_string(way.tags(), m_keys.at(index).c_str());
+    const char* value = TagDigest::value(way.tags(), m_keys.at(index).c_str());
+    set_fields(m_layers.at(index), way, m_keys.at(index).c_str(), value, tags_str);
+}
+
 void HighwayViewHandler::check_them_all(const osmium::Way& way) {
+    const bool count = m_check_counters.enabled() && !m_selection_mode;
     for (size_t i = 0; i < m_layers.size(); ++i) {
-        if (!m_checks.at(i)(way.tags())) {
-            if (!all_nodes_valid(way.nodes())) {
+        const bool failed = count
+            ? m_check_counters.run(i, [&]() { return !m_checks.at(i)(way.tags()); })
+            : !m_checks.at(i)(way.tags());
+        if (failed) {
+            if (!m_selection_mode && !all_nodes_valid(way.nodes())) {
                 return;
             }
-            std::string tags_str = tags_string(way.tags(), m_keys.at(i).c_str());
-            const char* value = way.get_value_by_key(m_keys.at(i).c_str());
-            set_fields(m_layers.at(i), way, m_keys.at(i).c_str(), value, tags_str);
+            write_check_failure(i, way);
         }
     }
 }
 
+void HighwayViewHandler::check_them_all(WayBatch& batch) {
+    m_batch_state.assign(batch.size(), BatchWayState::skip);
+    batch.for_each([this](const osmium::Way& way, const size_t index) {
+        if (TagDigest::value(way.tags(), TagKey::highway)) {
+            m_batch_state[index] = BatchWayState::unchecked;
+        }
+    });
+    const bool count = m_check_counters.enabled() && !m_selection_mode;
+    for (size_t i = 0; i < m_layers.size(); ++i) {
+        const std::function<bool (const osmium::TagList&)>& check = m_checks[i];
+        batch.for_each([this, i, count, &check](const osmium::Way& way, const size_t index) {
+            BatchWayState& state = m_batch_state[index];
+            // Like check_them_all(way), a way with invalid node locations is not checked
+            // any further after the first failed check.
+            if (state == BatchWayState::skip || state == BatchWayState::invalid_nodes) {
+                return;
+            }
+            const bool failed = count
+                ? m_check_counters.run(i, [&]() { return !check(way.tags()); })
+                : !check(way.tags());
+            if (!failed) {
+                return;
+            }
+            if (state == BatchWayState::unchecked) {
+                state = (m_selection_mode || all_nodes_valid(way.nodes()))
+                    ? BatchWayState::valid_nodes : BatchWayState::invalid_nodes;
+            }
+            if (state == BatchWayState::valid_nodes) {
+                write_check_failure(i, way);
+            }
+        });
+    }
+}
+
 void HighwayViewHandler::way(const osmium::Way& way) {
-    if (way.get_value_by_key("highway")) {
+    if (TagDigest::value(way.tags(), TagKey::highway)) {
         check_them_all(way);
+    }
+    check_remaining(way);
+}
+
+void HighwayViewHandler::way_batch(WayBatch& batch) {
+    // The checks of m_checks write to layers of their own. Running them check by check
+    // keeps the order of the features in each layer.
+    check_them_all(batch);
+    batch.for_each([this](const osmium::Way& way, const size_t) {
+        check_remaining(way);
+    });
+}
+
+void HighwayViewHandler::check_remaining(const osmium::Way& way) {
+    if (TagDigest::value(way.tags(), TagKey::highway)) {
         highway_unknown_way(way);
-        highway_multiple_lifecycle_states(way);
-        check_lanes_tags(way);
+        counted_step(m_lifecycle_counter, [&]() { highway_multiple_lifecycle_states(way); });
+        counted_step(m_lanes_counter, [&]() { check_lanes_tags(way); });
         ways_with_key(way, m_highway_abandoned.get(), "abandoned:highway", "abandoned");
         ways_with_key(way, m_highway_disused.get(), "disused:highway", "disused");
         ways_with_key(way, m_highway_construction.get(), "construction:highway", "construction");
@@ -34,7 +34,7 @@ struct charptr_comp {
     }
 };
 
-class HighwayViewHandler : public AbstractViewHandler {
+class HighwayViewHandler final : public AbstractViewHandler {
     /// layer for roads with abandoned:highway=*
     std::unique_ptr<gdalcpp::Layer> m_highway_abandoned;
     /// layer for roads with disused:highway=*
@@ -76,6 +76,23 @@ class HighwayViewHandler : public AbstractViewHandler {
     /// output layer for errorenous objects if the check fails
     std::vector<gdalcpp::Layer*> m_layers;
 
+    /// indexes of the checks in m_check_counters which are not part of m_checks
+    size_t m_lanes_counter;
+    size_t m_lifecycle_counter;
+
+    /// state of a way of a batch while the checks of m_checks are run over the batch
+    enum class BatchWayState : uint8_t {
+        /// no highway=*, the checks are not run
+        skip,
+        /// no check has failed yet, the node locations have not been checked
+        unchecked,
+        valid_nodes,
+        invalid_nodes
+    };
+
+    /// state of each way of the batch processed by way_batch
+    std::vector<BatchWayState> m_batch_state;
+
     /**
      * Check if the value of the maxspeed tag matches one of the common
      * values like RO:urban.
@@ -102,30 +119,33 @@ class HighwayViewHandler : public AbstractViewHandler {
      */
     template <typename TOsm>
     void set_fields(gdalcpp::Layer* layer, const TOsm& object, const char* third_field_name,
-            const char* third_field_value, std::string& other_tags,
+            const char* third_field_value, const char* other_tags,
             std::function<std::unique_ptr<OGRGeometry>(const TOsm&, ogr_factory_type&)> geom_func,
             const osmium::object_id_type id, const char* id_field_name, const char* key4 = nullptr,
             const char* field4 = nullptr) {
+        if (selection_only()) {
+            return;
+        }
         try {
-            gdalcpp::Feature feature(*layer, geom_func(object, m_factory));
+            OutputFeature feature(*layer, geom_func(object, m_factory));
             static char idbuffer[20];
             sprintf(idbuffer, "%ld", id);
             feature.set_field(id_field_name, idbuffer);
-            feature.set_field("tags", other_tags.c_str());
+            feature.set_field("tags", other_tags);
             if (third_field_name && third_field_value) {
                 feature.set_field(third_field_name, third_field_value);
             }
             if (key4 && field4) {
                 feature.set_field(key4, field4);
             }
-            feature.add_to_layer();
+            write_feature(feature);
         } catch (osmium::geometry_error& err) {
-            m_options.verbose_output << err.what() << "\n";
+            log_verbose(m_options.verbose_output, err.what(), "\n");
         }
     }
 
     void set_fields(gdalcpp::Layer* layer, const osmium::Way& way, const char* third_field_name,
-            const char* third_field_value, std::string& other_tags);
+            const char* third_field_value, const char* other_tags);
 
     /**
      * Check if a name is not a fixme placeholder, e.g. "fixme" or "unknown".
@@ -145,8 +165,6 @@ class HighwayViewHandler : public AbstractViewHandler {
 
     static bool oneway_ok(const osmium::TagList& tags);
 
-    static bool maxspeed_ok(const osmium::TagList& tags);
-
     static bool maxheight_ok(const osmium::TagList& tags);
 
     static bool maxweight_ok(const osmium::TagList& tags);
@@ -182,6 +200,25 @@ class HighwayViewHandler : public AbstractViewHandler {
      */
     void check_them_all(const osmium::Way& way);
 
+    /**
+     * Run all checks on all ways of a batch with highway=*. Each check is run over all ways
+     * before the next check is run.
+     */
+    void check_them_all(WayBatch& batch);
+
+    /**
+     * Write a way to the layer of a check of m_checks.
+     *
+     * \param index index of the check
+     * \param way way which failed the check
+     */
+    void write_check_failure(const size_t index, const osmium::Way& way);
+
+    /**
+     * Run the checks which are not registered in m_checks on a way.
+     */
+    void check_remaining(const osmium::Way& way);
+
     /**
      * Register a check to be run for each object
      *
@@ -197,10 +234,23 @@ class HighwayViewHandler : public AbstractViewHandler {
 
     int pipe_separated_items_count(const char* value);
 
+    bool supports_selection() const;
+
 public:
     HighwayViewHandler(Options& options, CreateLayerFunc create_layer);
 
     ViewType view_type() const;
+
+    bool limited_by_keys() const;
+
+    bool way_has_relevant_keys(const osmium::Way& way) const;
+
+    key_mask_type node_key_interest() const;
+
+    key_mask_type way_key_interest() const;
+
+    bool supports_batches() const;
+
     std::string view_name() const;
 
     void close();
@@ -209,6 +259,8 @@ public:
 
     void way(const osmium::Way& way);
 
+    void way_batch(WayBatch& batch);
+
     void relation(const osmium::Relation&) {};
     void area(const osmium::Area&) {};
 
@@ -219,6 +271,8 @@ public:
     static bool check_maxweight(const char* maxweight_value);
 
     static bool check_oneway(const char* oneway_value);
+
+    static bool maxspeed_ok(const osmium::TagList& tags);
 };
 
 
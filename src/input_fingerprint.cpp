@@ -0,0 +1,33 @@
+/*
+ * input_fingerprint.cpp
+ *
+ *  Created on:  2026-10-18
+ */
+
+#include <sys/stat.h>
+
+#include <osmium/io/any_input.hpp>
+
+#include "input_fingerprint.hpp"
+
+std::string input_fingerprint(const std::string& filename) {
+    if (filename.empty() || filename == "-") {
+        return "";
+    }
+    struct stat file_stat;
+    if (stat(filename.c_str(), &file_stat) != 0) {
+        return "";
+    }
+    osmium::io::Reader reader{filename, osmium::osm_entity_bits::nothing};
+    osmium::io::Header header = reader.header();
+    reader.close();
+    std::string fingerprint = "size=";
+    fingerprint += std::to_string(file_stat.st_size);
+    fingerprint += " mtime=";
+    fingerprint += std::to_string(file_stat.st_mtime);
+    fingerprint += " timestamp=";
+    fingerprint += header.get("timestamp");
+    fingerprint += " replication_timestamp=";
+    fingerprint += header.get("osmosis_replication_timestamp");
+    return fingerprint;
+}
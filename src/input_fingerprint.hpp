@@ -0,0 +1,26 @@
+/*
+ * input_fingerprint.hpp
+ *
+ *  Created on:  2026-10-18
+ */
+
+#ifndef SRC_INPUT_FINGERPRINT_HPP_
+#define SRC_INPUT_FINGERPRINT_HPP_
+
+#include <string>
+
+/**
+ * Build a string identifying the state of an input file.
+ *
+ * The fingerprint consists of the size and the modification time of the file and the
+ * timestamps stored in the header of the file. It is used to check if files derived from
+ * the input file (e.g. a location cache) are still valid.
+ *
+ * \param filename path to the input file
+ *
+ * \returns fingerprint or an empty string if the file cannot be accessed (e.g. if it is
+ * read from standard input)
+ */
+std::string input_fingerprint(const std::string& filename);
+
+#endif /* SRC_INPUT_FINGERPRINT_HPP_ */
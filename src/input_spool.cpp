@@ -0,0 +1,97 @@
+/*
+ * input_spool.cpp
+ *
+ *  Created on:  2026-10-18
+ */
+
+#include <cerrno>
+#include <cstring>
+#include <system_error>
+#include <vector>
+#include <stdlib.h>
+#include <unistd.h>
+
+#include "input_spool.hpp"
+
+namespace {
+
+    constexpr size_t chunk_size = 1024 * 1024;
+
+    /**
+     * Guess the suffix of the file from its first bytes. OSM XML starts with '<'. Everything
+     * else is treated as PBF which is what the extract tools write to standard output.
+     */
+    const char* detect_suffix(const char* data, const size_t size) {
+        if (size > 0 && data[0] == '<') {
+            return ".osm";
+        }
+        return ".osm.pbf";
+    }
+
+    void write_all(const int fd, const char* data, size_t size, const std::string& filename) {
+        while (size > 0) {
+            const ssize_t written = ::write(fd, data, size);
+            if (written < 0) {
+                if (errno == EINTR) {
+                    continue;
+                }
+                throw std::system_error{errno, std::system_category(), "Failed to write " + filename};
+            }
+            data += written;
+            size -= static_cast<size_t>(written);
+        }
+    }
+
+    /**
+     * Read from standard input until the buffer is full or the input ends.
+     */
+    size_t read_chunk(std::vector<char>& buffer) {
+        size_t size = 0;
+        while (size < buffer.size()) {
+            const ssize_t length = ::read(STDIN_FILENO, buffer.data() + size, buffer.size() - size);
+            if (length < 0) {
+                if (errno == EINTR) {
+                    continue;
+                }
+                throw std::system_error{errno, std::system_category(), "Failed to read standard input"};
+            }
+            if (length == 0) {
+                break;
+            }
+            size += static_cast<size_t>(length);
+        }
+        return size;
+    }
+
+} // namespace
+
+InputSpool::InputSpool(const std::string& directory) {
+    std::vector<char> buffer(chunk_size);
+    size_t size = read_chunk(buffer);
+    const char* suffix = detect_suffix(buffer.data(), size);
+    std::string filename = (directory.empty() ? std::string{"."} : directory) + "/.stdin-XXXXXX" + suffix;
+    const int fd = mkstemps(&filename[0], static_cast<int>(std::strlen(suffix)));
+    if (fd == -1) {
+        throw std::system_error{errno, std::system_category(), "Failed to create " + filename};
+    }
+    m_filename = filename;
+    try {
+        while (size > 0) {
+            write_all(fd, buffer.data(), size, m_filename);
+            size = read_chunk(buffer);
+        }
+    } catch (...) {
+        close(fd);
+        unlink(m_filename.c_str());
+        throw;
+    }
+    if (close(fd) != 0) {
+        const int error = errno;
+        unlink(m_filename.c_str());
+        throw std::system_error{error, std::system_category(), "Failed to write " + m_filename};
+    }
+}
+
+InputSpool::~InputSpool() {
+    unlink(m_filename.c_str());
+}
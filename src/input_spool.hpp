@@ -0,0 +1,48 @@
+/*
+ * input_spool.hpp
+ *
+ *  Created on:  2026-10-18
+ */
+
+#ifndef SRC_INPUT_SPOOL_HPP_
+#define SRC_INPUT_SPOOL_HPP_
+
+#include <string>
+
+/**
+ * Copy of the input read from standard input.
+ *
+ * Standard input can be read only once but the relation pass, the selection pass and the
+ * main pass read the input one after another. The stream is copied unchanged (still
+ * compressed) into a temporary file which is read by all passes instead. The file name
+ * gets the suffix of the detected format (PBF or XML) because the format cannot be derived
+ * from "-". The file is removed when the object is destroyed.
+ */
+class InputSpool {
+
+    std::string m_filename;
+
+public:
+    /**
+     * Copy standard input into a temporary file.
+     *
+     * \param directory directory to create the file in (current directory if empty)
+     *
+     * \throws std::system_error if the file cannot be created or written
+     */
+    explicit InputSpool(const std::string& directory);
+
+    InputSpool(const InputSpool&) = delete;
+    InputSpool& operator=(const InputSpool&) = delete;
+
+    ~InputSpool();
+
+    /**
+     * Path of the temporary file to be read instead of standard input.
+     */
+    const std::string& filename() const noexcept {
+        return m_filename;
+    }
+};
+
+#endif /* SRC_INPUT_SPOOL_HPP_ */
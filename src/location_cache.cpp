@@ -0,0 +1,56 @@
+/*
+ * location_cache.cpp
+ *
+ *  Created on:  2026-10-18
+ */
+
+#include <cerrno>
+#include <fstream>
+#include <system_error>
+#include <unistd.h>
+
+#include "input_fingerprint.hpp"
+#include "location_cache.hpp"
+
+LocationCache::LocationCache(const std::string& cache_filename, const std::string& input_filename) :
+        m_filename(cache_filename),
+        m_fingerprint(input_fingerprint(input_filename)) {
+}
+
+std::string LocationCache::meta_filename() const {
+    return m_filename + ".meta";
+}
+
+std::string LocationCache::index_type() const {
+    return "dense_file_array," + m_filename;
+}
+
+bool LocationCache::valid() const {
+    if (m_fingerprint.empty() || access(m_filename.c_str(), R_OK | W_OK) != 0) {
+        return false;
+    }
+    std::ifstream meta {meta_filename()};
+    std::string stored_fingerprint;
+    if (!meta || !std::getline(meta, stored_fingerprint)) {
+        return false;
+    }
+    return stored_fingerprint == m_fingerprint;
+}
+
+void LocationCache::invalidate() {
+    // Remove the meta file first. A cache file without a meta file is never used.
+    for (const std::string& path : {meta_filename(), m_filename}) {
+        if (unlink(path.c_str()) != 0 && errno != ENOENT) {
+            throw std::system_error{errno, std::system_category(), "Failed to remove " + path};
+        }
+    }
+}
+
+void LocationCache::commit() {
+    std::ofstream meta {meta_filename(), std::ios::trunc};
+    meta << m_fingerprint << '\n';
+    meta.close();
+    if (!meta) {
+        throw std::system_error{errno, std::system_category(), "Failed to write " + meta_filename()};
+    }
+}
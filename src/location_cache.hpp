@@ -0,0 +1,62 @@
+/*
+ * location_cache.hpp
+ *
+ *  Created on:  2026-10-18
+ */
+
+#ifndef SRC_LOCATION_CACHE_HPP_
+#define SRC_LOCATION_CACHE_HPP_
+
+#include <string>
+
+/**
+ * Node location cache persisted on disk between runs.
+ *
+ * The cache is a file in the format of osmium::index::map::DenseFileArray. A second file
+ * (cache file name + ".meta") contains the fingerprint of the input file the cache was built
+ * from. The meta file is written after the cache has been filled completely. A cache without
+ * a matching meta file is considered invalid.
+ */
+class LocationCache {
+
+    std::string m_filename;
+
+    std::string m_fingerprint;
+
+    std::string meta_filename() const;
+
+public:
+    LocationCache() = delete;
+
+    /**
+     * \param cache_filename path to the cache file
+     * \param input_filename path to the input file
+     */
+    LocationCache(const std::string& cache_filename, const std::string& input_filename);
+
+    /**
+     * Return the index type string for osmium::index::MapFactory.
+     */
+    std::string index_type() const;
+
+    /**
+     * Check if the cache was built from the current input file.
+     */
+    bool valid() const;
+
+    /**
+     * Remove the cache and its meta file.
+     *
+     * \throws std::system_error if the files exist but cannot be removed
+     */
+    void invalidate();
+
+    /**
+     * Mark the cache as complete for the current input file.
+     *
+     * \throws std::system_error if the meta file cannot be written
+     */
+    void commit();
+};
+
+#endif /* SRC_LOCATION_CACHE_HPP_ */
@@ -0,0 +1,114 @@
+/*
+ * memory_budget.cpp
+ *
+ *  Created on:  2026-10-18
+ */
+
+#include <algorithm>
+#include <iostream>
+#include <limits>
+#include <stdlib.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "memory_budget.hpp"
+
+namespace {
+
+    /// share of the budget for the node locations (percent)
+    constexpr size_t location_share = 60;
+
+    /// share of the budget for the SQLite page caches of all views (percent)
+    constexpr size_t sqlite_cache_share = 15;
+
+    /// share of the budget for the queues of the worker and writer threads (percent)
+    constexpr size_t queue_share = 5;
+
+    /// upper bound of bytes per node in a PBF file (the planet has about 8.5)
+    constexpr size_t bytes_per_node = 8;
+
+    /// memory used by sparse_mem_array per node including the growth of the vector
+    constexpr size_t sparse_bytes_per_node = 24;
+
+    /// above this number of nodes, a dense index is smaller than a sparse one
+    constexpr size_t dense_threshold = 1000000000;
+
+    /// approximate size of a buffer read from the input file (MB)
+    constexpr size_t buffer_size = 1;
+
+    /// approximate size of a feature waiting in the queue of a writer thread (bytes)
+    constexpr size_t feature_size = 1024;
+
+    size_t unique_view_count(const std::vector<ViewType>& views) {
+        std::vector<ViewType> unique {views};
+        std::sort(unique.begin(), unique.end());
+        return std::distance(unique.begin(), std::unique(unique.begin(), unique.end()));
+    }
+
+} // namespace
+
+size_t parse_memory_size(const char* argument) {
+    char* end = nullptr;
+    long size = strtol(argument, &end, 10);
+    if (size <= 0) {
+        return 0;
+    }
+    if (*end == 'G' || *end == 'g') {
+        size *= 1024;
+        ++end;
+    } else if (*end == 'M' || *end == 'm') {
+        ++end;
+    }
+    if (*end != '\0') {
+        return 0;
+    }
+    return static_cast<size_t>(size);
+}
+
+std::string apply_memory_budget(Options& options, const std::string& input_filename,
+        const bool choose_index_type) {
+    // All shard processes run at the same time and share the budget.
+    const size_t budget = std::max<size_t>(1, options.max_memory / options.shard_count);
+    const size_t views = std::max<size_t>(1, unique_view_count(options.views));
+    options.verbose_output << "Memory budget: " << budget << " MB\n";
+
+    options.sqlite_cache = std::max<size_t>(16, budget * sqlite_cache_share / 100 / views);
+    // The queues of the worker threads and of the writer threads get half of the share each.
+    const size_t queue_budget = std::max<size_t>(1, budget * queue_share / 100 / 2 / views);
+    options.worker_queue_size = std::min<size_t>(20, std::max<size_t>(2, queue_budget / buffer_size));
+    options.writer_queue_size = std::min<size_t>(10000,
+            std::max<size_t>(1000, queue_budget * 1024 * 1024 / feature_size));
+    options.verbose_output << "  SQLite cache: " << options.sqlite_cache << " MB per view\n";
+    options.verbose_output << "  queue sizes: " << options.worker_queue_size << " buffers per worker, "
+        << options.writer_queue_size << " features per writer\n";
+
+    if (!choose_index_type) {
+        return "";
+    }
+    // Standard input has an unknown size and gets a file-backed index.
+    size_t estimated_nodes = std::numeric_limits<size_t>::max() / sparse_bytes_per_node;
+    struct stat input_stat;
+    if (input_filename != "-" && stat(input_filename.c_str(), &input_stat) == 0) {
+        estimated_nodes = static_cast<size_t>(input_stat.st_size) / bytes_per_node;
+    }
+    const size_t sparse_size = estimated_nodes / 1024 * sparse_bytes_per_node / 1024;
+    if (sparse_size <= budget * location_share / 100) {
+        options.location_index_type = "sparse_mem_array";
+        options.verbose_output << "  location index: sparse_mem_array (about " << sparse_size << " MB)\n";
+        return "";
+    }
+    // The index does not fit into memory. A file-backed index is paged in and out by the
+    // kernel instead of exceeding the budget.
+    std::string index_filename = options.output_directory + "/.locations-XXXXXX";
+    const int fd = mkstemp(&index_filename[0]);
+    if (fd == -1) {
+        std::cerr << "ERROR: Failed to create location index file in " << options.output_directory << '\n';
+        exit(1);
+    }
+    close(fd);
+    const char* type = (estimated_nodes > dense_threshold) ? "dense_file_array" : "sparse_file_array";
+    options.location_index_type = std::string{type} + "," + index_filename;
+    options.verbose_output << "  location index: " << type << " in " << index_filename
+        << " (about " << sparse_size << " MB needed for sparse_mem_array)\n";
+    return index_filename;
+}
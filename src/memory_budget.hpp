@@ -0,0 +1,42 @@
+/*
+ * memory_budget.hpp
+ *
+ *  Created on:  2026-10-18
+ */
+
+#ifndef SRC_MEMORY_BUDGET_HPP_
+#define SRC_MEMORY_BUDGET_HPP_
+
+#include <string>
+#include <vector>
+
+#include <osmium/util/verbose_output.hpp>
+
+#include "options.hpp"
+
+/**
+ * Parse the argument of --max-memory. The size is given in MB, a suffix G or M is allowed.
+ *
+ * \returns size in MB, 0 if the argument is invalid
+ */
+size_t parse_memory_size(const char* argument);
+
+/**
+ * Size the components using a lot of memory to fit into Options::max_memory.
+ *
+ * The number of nodes is estimated from the size of the input file. If the node locations
+ * do not fit into their share of the budget, a file-backed index in the output directory is
+ * used. The SQLite page cache and the queues of the worker and writer threads get fixed
+ * shares of the budget. Shard processes (--shard K/N) get 1/N of the budget.
+ *
+ * \param options options to be modified
+ * \param input_filename input file ("-" for standard input)
+ * \param choose_index_type true if the location index type should be chosen
+ *
+ * \returns path of the file-backed location index to be removed after the index was
+ * created, empty if the index is held in memory
+ */
+std::string apply_memory_budget(Options& options, const std::string& input_filename,
+        const bool choose_index_type);
+
+#endif /* SRC_MEMORY_BUDGET_HPP_ */
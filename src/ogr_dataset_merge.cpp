@@ -0,0 +1,303 @@
+/*
+ * ogr_dataset_merge.cpp
+ *
+ *  Created on:  2026-10-18
+ */
+
+#include <algorithm>
+#include <array>
+#include <cerrno>
+#include <cstring>
+#include <memory>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#include <dirent.h>
+#include <stdio.h>
+#include <strings.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <gdal_priv.h>
+#include <ogrsf_frmts.h>
+
+#include "ogr_dataset_merge.hpp"
+
+namespace {
+
+    struct GDALDatasetDeleter {
+        void operator()(GDALDataset* ds) const {
+            GDALClose(static_cast<GDALDatasetH>(ds));
+        }
+    };
+
+    using dataset_ptr = std::unique_ptr<GDALDataset, GDALDatasetDeleter>;
+
+    struct IdField {
+        int index;
+        osmium::item_type type;
+    };
+
+    dataset_ptr open_dataset(const std::string& path, const unsigned int flags) {
+        dataset_ptr ds {static_cast<GDALDataset*>(GDALOpenEx(path.c_str(), GDAL_OF_VECTOR | flags,
+                nullptr, nullptr, nullptr))};
+        if (!ds) {
+            throw std::runtime_error{"Failed to open dataset " + path};
+        }
+        return ds;
+    }
+
+    std::vector<IdField> id_fields(OGRFeatureDefn* defn) {
+        const std::array<std::pair<const char*, osmium::item_type>, 3> names = {{
+            {"node_id", osmium::item_type::node},
+            {"way_id", osmium::item_type::way},
+            {"rel_id", osmium::item_type::relation}
+        }};
+        std::vector<IdField> fields;
+        for (const auto& n : names) {
+            const int index = defn->GetFieldIndex(n.first);
+            if (index >= 0) {
+                fields.push_back(IdField{index, n.second});
+            }
+        }
+        return fields;
+    }
+
+    size_t delete_replaced(OGRLayer* layer, const replaced_func_type& replaced) {
+        const std::vector<IdField> fields = id_fields(layer->GetLayerDefn());
+        if (fields.empty()) {
+            return 0;
+        }
+        std::vector<GIntBig> fids;
+        layer->ResetReading();
+        OGRFeature* feature;
+        while ((feature = layer->GetNextFeature()) != nullptr) {
+            for (const IdField& f : fields) {
+                if (feature->IsFieldSetAndNotNull(f.index)
+                        && replaced(f.type, feature->GetFieldAsInteger64(f.index))) {
+                    fids.push_back(feature->GetFID());
+                    break;
+                }
+            }
+            OGRFeature::DestroyFeature(feature);
+        }
+        for (const GIntBig fid : fids) {
+            if (layer->DeleteFeature(fid) != OGRERR_NONE) {
+                throw std::runtime_error{std::string{"Failed to delete feature from layer "} + layer->GetName()};
+            }
+        }
+        return fids.size();
+    }
+
+    size_t append_features(OGRLayer* source_layer, OGRLayer* destination_layer) {
+        size_t count = 0;
+        source_layer->ResetReading();
+        OGRFeature* feature;
+        while ((feature = source_layer->GetNextFeature()) != nullptr) {
+            OGRFeature* out = OGRFeature::CreateFeature(destination_layer->GetLayerDefn());
+            out->SetFrom(feature, TRUE);
+            out->SetFID(OGRNullFID);
+            const OGRErr result = destination_layer->CreateFeature(out);
+            OGRFeature::DestroyFeature(out);
+            OGRFeature::DestroyFeature(feature);
+            if (result != OGRERR_NONE) {
+                throw std::runtime_error{std::string{"Failed to add feature to layer "} + destination_layer->GetName()};
+            }
+            ++count;
+        }
+        return count;
+    }
+
+    /**
+     * Get the names of all files in a directory except hidden ones.
+     */
+    std::vector<std::string> list_directory(const std::string& directory) {
+        std::vector<std::string> names;
+        DIR* dir = opendir(directory.c_str());
+        if (!dir) {
+            throw std::runtime_error{"Failed to open directory " + directory + ": " + strerror(errno)};
+        }
+        struct dirent* entry;
+        while ((entry = readdir(dir)) != nullptr) {
+            if (entry->d_name[0] != '.') {
+                names.emplace_back(entry->d_name);
+            }
+        }
+        closedir(dir);
+        return names;
+    }
+
+    /**
+     * Files of one dataset in a directory. A Shapefile consists of the .shp file and
+     * sidecar files with the same stem.
+     */
+    struct DatasetFiles {
+        /// name of the file to open
+        std::string main;
+
+        /// names of all files of the dataset including the main file
+        std::vector<std::string> files;
+    };
+
+    bool has_extension(const std::string& name, const std::string& stem, const char* extension) {
+        return name.size() == stem.size() + 1 + strlen(extension)
+            && !name.compare(0, stem.size(), stem)
+            && name[stem.size()] == '.'
+            && !strcasecmp(name.c_str() + stem.size() + 1, extension);
+    }
+
+    /**
+     * Check if a file is a sidecar file of a Shapefile.
+     */
+    bool is_sidecar(const std::string& name) {
+        const size_t dot = name.rfind('.');
+        if (dot == std::string::npos) {
+            return false;
+        }
+        const std::string stem = name.substr(0, dot);
+        for (const char* extension : {"dbf", "shx", "prj", "cpg", "qix", "sbn", "sbx"}) {
+            if (has_extension(name, stem, extension)) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    /**
+     * Get the datasets in a directory. Sidecar files are assigned to the Shapefile with the
+     * same stem. They are only treated as datasets of their own if there is no such
+     * Shapefile.
+     */
+    std::vector<DatasetFiles> list_datasets(const std::string& directory) {
+        std::vector<std::string> names = list_directory(directory);
+        std::sort(names.begin(), names.end());
+        std::vector<DatasetFiles> datasets;
+        std::vector<std::string> sidecars;
+        for (std::string& name : names) {
+            if (is_sidecar(name)) {
+                sidecars.push_back(std::move(name));
+            } else {
+                datasets.push_back(DatasetFiles{name, {name}});
+            }
+        }
+        for (std::string& sidecar : sidecars) {
+            const std::string stem = sidecar.substr(0, sidecar.rfind('.'));
+            auto shapefile = std::find_if(datasets.begin(), datasets.end(), [&stem](const DatasetFiles& d) {
+                return has_extension(d.main, stem, "shp");
+            });
+            if (shapefile != datasets.end()) {
+                shapefile->files.push_back(std::move(sidecar));
+            } else {
+                datasets.push_back(DatasetFiles{sidecar, {sidecar}});
+            }
+        }
+        return datasets;
+    }
+
+    /**
+     * Remove a file or a directory with all its content. Errors are ignored.
+     */
+    void remove_path(const std::string& path) {
+        struct stat st;
+        if (lstat(path.c_str(), &st) != 0) {
+            return;
+        }
+        if (!S_ISDIR(st.st_mode)) {
+            unlink(path.c_str());
+            return;
+        }
+        DIR* dir = opendir(path.c_str());
+        if (dir) {
+            struct dirent* entry;
+            std::vector<std::string> names;
+            while ((entry = readdir(dir)) != nullptr) {
+                if (strcmp(entry->d_name, ".") && strcmp(entry->d_name, "..")) {
+                    names.emplace_back(entry->d_name);
+                }
+            }
+            closedir(dir);
+            for (const std::string& name : names) {
+                remove_path(path + '/' + name);
+            }
+        }
+        rmdir(path.c_str());
+    }
+
+} // namespace
+
+void merge_dataset(const std::string& source, const std::string& destination,
+        replaced_func_type replaced, osmium::util::VerboseOutput& verbose_output) {
+    dataset_ptr src = open_dataset(source, GDAL_OF_READONLY);
+    dataset_ptr dst = open_dataset(destination, GDAL_OF_UPDATE);
+    for (int i = 0; i < src->GetLayerCount(); ++i) {
+        OGRLayer* src_layer = src->GetLayer(i);
+        OGRLayer* dst_layer = dst->GetLayerByName(src_layer->GetName());
+        if (!dst_layer) {
+            throw std::runtime_error{std::string{"Layer "} + src_layer->GetName() + " is missing in " + destination};
+        }
+        if (replaced && !dst_layer->TestCapability(OLCDeleteFeature)) {
+            throw std::runtime_error{"Output format of " + destination + " does not support deleting features"};
+        }
+        const bool transaction = (dst->StartTransaction() == OGRERR_NONE);
+        const size_t deleted = replaced ? delete_replaced(dst_layer, replaced) : 0;
+        const size_t added = append_features(src_layer, dst_layer);
+        if (transaction && dst->CommitTransaction() != OGRERR_NONE) {
+            throw std::runtime_error{"Failed to commit changes to " + destination};
+        }
+        verbose_output << "  " << src_layer->GetName() << ": " << deleted << " features removed, "
+                << added << " features added\n";
+    }
+}
+
+void merge_directory(const std::string& source_directory, const std::string& destination_directory,
+        replaced_func_type replaced, osmium::util::VerboseOutput& verbose_output) {
+    for (const DatasetFiles& dataset : list_datasets(source_directory)) {
+        const std::string source = source_directory + '/' + dataset.main;
+        const std::string destination = destination_directory + '/' + dataset.main;
+        if (access(destination.c_str(), F_OK) != 0) {
+            throw std::runtime_error{"Cannot update " + destination + " because it does not exist."};
+        }
+        verbose_output << "Merging " << source << " into " << destination << '\n';
+        merge_dataset(source, destination, replaced, verbose_output);
+        for (const std::string& name : dataset.files) {
+            remove_path(source_directory + '/' + name);
+        }
+    }
+    rmdir(source_directory.c_str());
+}
+
+std::vector<std::string> merge_shard_directories(const std::vector<std::string>& source_directories,
+        const std::string& destination_directory, osmium::util::VerboseOutput& verbose_output) {
+    // datasets created by this function
+    std::vector<std::string> created;
+    std::vector<std::string> destinations;
+    for (const std::string& source_directory : source_directories) {
+        for (const DatasetFiles& dataset : list_datasets(source_directory)) {
+            const std::string destination = destination_directory + '/' + dataset.main;
+            if (std::find(created.begin(), created.end(), dataset.main) == created.end()) {
+                for (const std::string& name : dataset.files) {
+                    const std::string source_file = source_directory + '/' + name;
+                    const std::string destination_file = destination_directory + '/' + name;
+                    if (access(destination_file.c_str(), F_OK) == 0) {
+                        throw std::runtime_error{"Cannot move " + source_file + " to " + destination_file + " because file exists already."};
+                    }
+                    if (rename(source_file.c_str(), destination_file.c_str())) {
+                        throw std::runtime_error{"Rename from " + source_file + " to " + destination_file + " failed: " + strerror(errno)};
+                    }
+                }
+                created.push_back(dataset.main);
+                destinations.push_back(destination);
+            } else {
+                const std::string source = source_directory + '/' + dataset.main;
+                verbose_output << "Merging " << source << " into " << destination << '\n';
+                merge_dataset(source, destination, nullptr, verbose_output);
+                for (const std::string& name : dataset.files) {
+                    remove_path(source_directory + '/' + name);
+                }
+            }
+        }
+        rmdir(source_directory.c_str());
+    }
+    return destinations;
+}
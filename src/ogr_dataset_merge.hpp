@@ -0,0 +1,74 @@
+/*
+ * ogr_dataset_merge.hpp
+ *
+ *  Created on:  2026-10-18
+ */
+
+#ifndef SRC_OGR_DATASET_MERGE_HPP_
+#define SRC_OGR_DATASET_MERGE_HPP_
+
+#include <functional>
+#include <string>
+#include <vector>
+
+#include <osmium/osm/item_type.hpp>
+#include <osmium/osm/types.hpp>
+#include <osmium/util/verbose_output.hpp>
+
+/**
+ * Function returning true if the features of an OSM object in the destination dataset are
+ * replaced by the features in the source dataset.
+ */
+using replaced_func_type = std::function<bool(const osmium::item_type, const osmium::object_id_type)>;
+
+/**
+ * Merge the features of all layers of a dataset into an existing dataset.
+ *
+ * Features in the destination dataset are deleted if the value of one of their fields
+ * `node_id`, `way_id` or `rel_id` refers to an object which is replaced. Afterwards, all
+ * features of the source dataset are appended to the layer with the same name in the
+ * destination dataset.
+ *
+ * \param source path to the dataset to read from
+ * \param destination path to the dataset to be updated
+ * \param replaced function telling which objects are replaced. If it is empty, no features are
+ *        deleted.
+ * \param verbose_output output stream for progress messages
+ *
+ * \throws std::runtime_error if a dataset cannot be opened, a layer is missing in the
+ * destination or writing fails
+ */
+void merge_dataset(const std::string& source, const std::string& destination,
+        replaced_func_type replaced, osmium::util::VerboseOutput& verbose_output);
+
+/**
+ * Merge all datasets in a directory into the datasets with the same file name in another
+ * directory using merge_dataset. The merged datasets and the source directory are removed
+ * afterwards.
+ *
+ * A Shapefile is merged as one dataset. Its sidecar files (.dbf, .shx, .prj etc.) are not
+ * opened on their own but removed together with the .shp file. Datasets which are
+ * directories (e.g. Shapefile output without suffix) are removed with their content.
+ *
+ * \throws std::runtime_error if a destination dataset is missing or merging fails
+ */
+void merge_directory(const std::string& source_directory, const std::string& destination_directory,
+        replaced_func_type replaced, osmium::util::VerboseOutput& verbose_output);
+
+/**
+ * Combine the output directories of shard processes.
+ *
+ * The datasets of the first directory containing a dataset are moved to the destination
+ * directory. The features of the datasets with the same name in the other directories are
+ * appended to them. The source directories are removed afterwards. Like merge_directory,
+ * the sidecar files of a Shapefile are moved or removed together with the .shp file.
+ *
+ * \returns paths of the datasets (main files only) in the destination directory
+ *
+ * \throws std::runtime_error if a file exists in the destination directory already or if
+ * merging fails
+ */
+std::vector<std::string> merge_shard_directories(const std::vector<std::string>& source_directories,
+        const std::string& destination_directory, osmium::util::VerboseOutput& verbose_output);
+
+#endif /* SRC_OGR_DATASET_MERGE_HPP_ */
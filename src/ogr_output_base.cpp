@@ -22,3 +22,35 @@
 
 OGROutputBase::OGROutputBase(Options& options) :
         m_options(options) { }
+
+void OGROutputBase::write_feature(OutputFeature& feature) {
+    ++m_features_written;
+    const bool collect_statistics = !m_options.stats_file.empty();
+    const stats_clock::time_point start = collect_statistics ? stats_clock::now() : stats_clock::time_point{};
+    gdalcpp::Layer& layer = feature.layer();
+    const LayerFields* layer_fields = feature.captured_fields();
+    FeatureWriter* writer = nullptr;
+    // Features built as OGR features are written right away.
+    if (layer_fields && m_layer_writers) {
+        auto it = m_layer_writers->find(&layer);
+        if (it != m_layer_writers->end()) {
+            writer = it->second;
+        }
+    }
+    if (writer) {
+        writer->write(std::move(feature));
+    } else {
+        feature.write_to_layer();
+    }
+    if (!collect_statistics) {
+        return;
+    }
+    // If the feature is written by a writer thread, this is the time to enqueue it.
+    m_output_statistics.ogr_time += stats_clock::now() - start;
+    OutputStatistics::LayerStatistics& layer_statistics = m_output_statistics.layers[&layer];
+    if (layer_statistics.name.empty()) {
+        // The layer must not be touched if it is written by a writer thread.
+        layer_statistics.name = layer_fields ? layer_fields->name() : layer.name();
+    }
+    ++layer_statistics.features;
+}
@@ -33,7 +33,10 @@
 
 #include <osmium/util/verbose_output.hpp>
 
+#include "feature_writer.hpp"
 #include "options.hpp"
+#include "output_feature.hpp"
+#include "run_statistics.hpp"
 
 /**
  * If ONLYMERCATOROUTPUT is defined, output coordinates are always Web
@@ -59,11 +62,38 @@ protected:
     /// maximum length of a string field
     static constexpr size_t MAX_FIELD_LENGTH = 254;
 
+    OutputStatistics m_output_statistics;
+
+    /// number of features written by this instance
+    size_t m_features_written = 0;
+
+    /// writers of layers which are not written using OGR by this class (nullptr if none)
+    const layer_writer_map* m_layer_writers = nullptr;
+
+    /**
+     * Add a feature to its layer or hand it over to the writer of its dataset. Time and
+     * number of features are recorded if statistics are enabled.
+     */
+    void write_feature(OutputFeature& feature);
+
 public:
     OGROutputBase() = delete;
 
     OGROutputBase(Options& options);
 
+    /**
+     * Set the writers of layers which should not be written using OGR by this class.
+     *
+     * \param writers map of layers and their writers (has to outlive this object)
+     */
+    void set_layer_writers(const layer_writer_map* writers) noexcept {
+        m_layer_writers = writers;
+    }
+
+    const OutputStatistics& output_statistics() const noexcept {
+        return m_output_statistics;
+    }
+
     using CreateLayerFunc = std::function<std::unique_ptr<gdalcpp::Layer>(const char*, OGRwkbGeometryType)>;
 };
 
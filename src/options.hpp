@@ -21,6 +21,12 @@ enum class ViewType : char {
     turn_restrictions = 6
 };
 
+/**
+ * Number of values of ViewType, used as size of arrays indexed by a view. It has to be derived
+ * from the last value of ViewType.
+ */
+constexpr size_t view_type_count = static_cast<size_t>(ViewType::turn_restrictions) + 1;
+
 /**
  * options for program execution
  */
@@ -35,6 +41,43 @@ struct Options {
     const int srs = 4326;
 #endif
     osmium::util::VerboseOutput verbose_output {false};
+    /// Number of worker threads running the views. 1 means that all views run on the main thread.
+    size_t threads = 1;
+    /// Select ways producing output first and store only the locations of their nodes.
+    bool lazy_locations = false;
+    /// Write the output datasets of each view on a dedicated thread.
+    bool writer_threads = false;
+    /// Write SQlite output using prepared statements instead of OGR.
+    bool native_sqlite = false;
+    /// Build a spatial index of each layer after all features have been written (SQlite only).
+    bool spatial_index = false;
+    /// Memory budget in MB (--max-memory). 0 means that the defaults below are used.
+    size_t max_memory = 0;
+    /// Size of the SQLite page cache of each dataset (OGR_SQLITE_CACHE) in MB
+    size_t sqlite_cache = 600;
+    /// Maximum number of buffers waiting for each view worker thread
+    size_t worker_queue_size = 20;
+    /// Maximum number of features waiting for each writer thread
+    size_t writer_queue_size = 10000;
+    /// Path to the persistent node location cache. Empty if no cache should be used.
+    std::string location_cache = "";
+    /// Path to the checkpoint of the relation pass. Empty if no checkpoint should be written.
+    std::string checkpoint = "";
+    /// Read the relations from the checkpoint if it is valid.
+    bool resume = false;
+    /// Path to the JSON file where statistics of the run are written to. Empty if no
+    /// statistics should be collected.
+    std::string stats_file = "";
+    /// Count evaluations, hits and time of the individual checks and print them at the end.
+    bool check_counters = false;
+    /// OSC file with the changes since the run which produced the output files to be updated
+    std::string changes_file = "";
+    /// Number of shard processes to spawn (--shards). 0 means that no processes are spawned.
+    size_t spawn_shards = 0;
+    /// Shard processed by this process (--shard K/N)
+    size_t shard_index = 0;
+    /// Total number of shards. 1 means that the input is not sharded.
+    size_t shard_count = 1;
 
     /**
      * Return capability to create multiple layers with one data source.
@@ -43,7 +86,16 @@ struct Options {
      */
     bool one_layer_per_datasource_only() {
         return case_insensitive_comp_left(output_format, "geojson")
-            || case_insensitive_comp_left(output_format, "esri shapefile");
+            || case_insensitive_comp_left(output_format, "esri shapefile")
+            || flatgeobuf();
+    }
+
+    /**
+     * Check if the output format is FlatGeobuf. FlatGeobuf files cannot be modified after
+     * they have been closed.
+     */
+    bool flatgeobuf() const {
+        return case_insensitive_comp_left(output_format, "flatgeobuf");
     }
 
     /**
@@ -17,14 +17,20 @@
  *  along with osmi_simple_views. If not, see <http://www.gnu.org/licenses/>.
  */
 
+#include <algorithm>
 #include <string>
+#include <system_error>
 #include <iostream>
 #include <getopt.h>
+#include <stdlib.h>
+#include <unistd.h>
 
 #include <osmium/area/assembler.hpp>
 #include <osmium/area/multipolygon_collector.hpp>
 // the indexes themselves have to be included first
+#include <osmium/index/map/dense_file_array.hpp>
 #include <osmium/index/map/dense_mmap_array.hpp>
+#include <osmium/index/map/sparse_file_array.hpp>
 #include <osmium/index/map/sparse_mmap_array.hpp>
 #include <osmium/index/map/dense_mem_array.hpp>
 #include <osmium/index/map/sparse_mem_array.hpp>
@@ -34,9 +40,21 @@
 #include <osmium/visitor.hpp>
 
 #include "any_relation_collector.hpp"
+#include "change_set.hpp"
 #include "highway_relation_manager.hpp"
+#include "input_fingerprint.hpp"
+#include "input_spool.hpp"
 #include "turn_restrictions_manager.hpp"
 #include "handler_collection.hpp"
+#include "location_cache.hpp"
+#include "memory_budget.hpp"
+#include "ogr_dataset_merge.hpp"
+#include "relation_blocks.hpp"
+#include "relation_checkpoint.hpp"
+#include "run_statistics.hpp"
+#include "selective_node_locations.hpp"
+#include "shard_runner.hpp"
+#include "view_worker_pool.hpp"
 
 using index_type = osmium::index::map::Map<osmium::unsigned_object_id_type, osmium::Location>;
 using location_handler_type = osmium::handler::NodeLocationsForWays<index_type>;
@@ -46,12 +64,56 @@ void print_help(char* arg0) {
               << "Options:\n" \
               << "  -h, --help           This help message.\n" \
               << "  -f, --format         Output format (default: SQlite)\n" \
-              << "  -i, --index          Set index type for location index (default: sparse_mem_array)\n";
+              << "  -C FILE, --checkpoint=FILE\n" \
+              << "                       Write the relations needed by the views to FILE after\n" \
+              << "                       the relation pass.\n" \
+              << "  -r, --resume         Read the relations from the checkpoint instead of the\n" \
+              << "                       input file if the checkpoint matches the input file\n" \
+              << "                       and the options.\n" \
+              << "  --stats=FILE         Write time, throughput, number of features and memory\n" \
+              << "                       usage of each pass and each view to FILE (JSON).\n" \
+              << "  --check-counters     Count evaluations and hits of the checks of the\n" \
+              << "                       highways and tagging views, measure their time and\n" \
+              << "                       print the counters at the end.\n" \
+              << "  -i, --index          Set index type for location index (default: sparse_mem_array)\n" \
+              << "  --max-memory=SIZE    Memory budget in MB (suffix G for GB). Chooses the location\n" \
+              << "                       index (file-backed if the nodes do not fit), the SQLite\n" \
+              << "                       cache and the queue sizes. -i and --location-cache\n" \
+              << "                       take precedence for the location index.\n" \
+              << "  -j N, --threads=N    Run the views on up to N worker threads (default: 1)\n" \
+              << "  -W, --writer-threads Write the output datasets of each view on a separate\n" \
+              << "                       thread. Views write to their datasets in parallel.\n" \
+              << "  --native-sqlite      Insert the features of SQlite output using prepared\n" \
+              << "                       statements instead of OGR (same schema).\n" \
+              << "  --spatial-index      Build a spatial index of each layer of SQlite output\n" \
+              << "                       after all features have been written.\n" \
+              << "  -l, --lazy-locations Read the ways twice and store the locations of nodes\n" \
+              << "                       of ways producing output only. Saves memory for the\n" \
+              << "                       highways, tagging, sac_scale and turn_restrictions views.\n" \
+              << "  -c FILE, --location-cache=FILE\n" \
+              << "                       Store node locations in FILE and reuse them in later runs\n" \
+              << "                       on the same input file. Overrides --index.\n" \
+              << "  -u FILE, --update=FILE\n" \
+              << "                       Update the output files of a previous run in\n" \
+              << "                       OUTPUT_DIRECTORY. FILE is the OSC file with the changes\n" \
+              << "                       between the previous and the current INPUT_FILE.\n" \
+              << "                       The places view is not supported. Ways removed from\n" \
+              << "                       a relation or members of a deleted relation keep the\n" \
+              << "                       attributes derived from it until they change.\n" \
+              << "  --shards=N           Split the input into N longitude bands and process them\n" \
+              << "                       in N processes. The output of the processes is merged.\n" \
+              << "                       Requires a --location-cache built by a run without\n" \
+              << "                       --shards. The processes share its node locations.\n" \
+              << "  --shard=K/N          Only process shard K (counted from 0) of N. Ways belong\n" \
+              << "                       to the shard of their first node, relations are\n" \
+              << "                       distributed by their ID.\n";
     std::cerr << "  -t TYPE, --type=TYPE View to be produced (tagging, highways, places, geometry,\n" \
                  "                       sac_scale, turn_restrictions).\n" \
               << "                       Use `-t view1 -t view2` if you want to produce files of\n" \
               << "                       multiple views.\n" \
               << "  -v, --verbose        Verbose output\n";
+    std::cerr << "\nINPUT_FILE - reads standard input. If the views need more than one pass over\n" \
+                 "the input, it is copied to a temporary file in OUTPUT_DIRECTORY first.\n";
     std::cerr << "\n"
 #ifdef ONLYMERCATOROUTPUT
               << "Output is written in EPSG:3857 (Web Mercator).\n";
@@ -66,20 +128,65 @@ int main(int argc, char* argv[]) {
         {"help",   no_argument, 0, 'h'},
         {"format", required_argument, 0, 'f'},
         {"index", required_argument, 0, 'i'},
+        {"threads", required_argument, 0, 'j'},
+        {"writer-threads", no_argument, 0, 'W'},
+        {"lazy-locations", no_argument, 0, 'l'},
+        {"location-cache", required_argument, 0, 'c'},
+        {"checkpoint", required_argument, 0, 'C'},
+        {"resume", no_argument, 0, 'r'},
+        // no short option
+        {"stats", required_argument, 0, 1},
+        {"check-counters", no_argument, 0, 2},
+        {"native-sqlite", no_argument, 0, 3},
+        {"spatial-index", no_argument, 0, 4},
+        {"max-memory", required_argument, 0, 5},
+        {"update", required_argument, 0, 'u'},
+        {"shards", required_argument, 0, 'S'},
+        {"shard", required_argument, 0, 's'},
         {"type",   required_argument, 0, 't'},
         {"verbose",   no_argument, 0, 'v'},
         {0, 0, 0, 0}
     };
 
     Options options;
+    bool index_type_given = false;
 
     while (true) {
-        int c = getopt_long(argc, argv, "hf:i:t:v", long_options, 0);
+        int c = getopt_long(argc, argv, "C:c:hf:i:j:lrS:s:t:u:vW", long_options, 0);
         if (c == -1) {
             break;
         }
 
         switch (c) {
+            case 'c':
+                options.location_cache = optarg;
+                break;
+            case 'C':
+                options.checkpoint = optarg;
+                break;
+            case 'r':
+                options.resume = true;
+                break;
+            case 1:
+                options.stats_file = optarg;
+                break;
+            case 2:
+                options.check_counters = true;
+                break;
+            case 3:
+                options.native_sqlite = true;
+                break;
+            case 4:
+                options.spatial_index = true;
+                break;
+            case 5:
+                options.max_memory = parse_memory_size(optarg);
+                if (options.max_memory == 0) {
+                    std::cerr << "ERROR: --max-memory must be a positive size in MB or GB (suffix G)\n";
+                    print_help(argv[0]);
+                    exit(1);
+                }
+                break;
             case 'h':
                 print_help(argv[0]);
                 exit(1);
@@ -94,11 +201,30 @@ int main(int argc, char* argv[]) {
             case 'i':
                 if (optarg) {
                     options.location_index_type = optarg;
+                    index_type_given = true;
                 } else {
                     print_help(argv[0]);
                     exit(1);
                 }
                 break;
+            case 'j':
+                {
+                    char* end = nullptr;
+                    long threads = strtol(optarg, &end, 10);
+                    if (*end != '\0' || threads < 1) {
+                        std::cerr << "ERROR: -j must be a positive integer\n";
+                        print_help(argv[0]);
+                        exit(1);
+                    }
+                    options.threads = static_cast<size_t>(threads);
+                }
+                break;
+            case 'l':
+                options.lazy_locations = true;
+                break;
+            case 'W':
+                options.writer_threads = true;
+                break;
             case 't':
                 if (!strcmp(optarg, "tagging")) {
                     options.views.push_back(ViewType::tagging);
@@ -118,6 +244,35 @@ int main(int argc, char* argv[]) {
                     exit(1);
                 }
                 break;
+            case 'u':
+                options.changes_file = optarg;
+                break;
+            case 'S':
+                {
+                    char* end = nullptr;
+                    long shards = strtol(optarg, &end, 10);
+                    if (*end != '\0' || shards < 1) {
+                        std::cerr << "ERROR: --shards must be a positive integer\n";
+                        print_help(argv[0]);
+                        exit(1);
+                    }
+                    options.spawn_shards = static_cast<size_t>(shards);
+                }
+                break;
+            case 's':
+                {
+                    char* end = nullptr;
+                    long index = strtol(optarg, &end, 10);
+                    long count = (*end == '/') ? strtol(end + 1, &end, 10) : 0;
+                    if (*end != '\0' || index < 0 || count < 1 || index >= count) {
+                        std::cerr << "ERROR: --shard must be K/N with 0 <= K < N\n";
+                        print_help(argv[0]);
+                        exit(1);
+                    }
+                    options.shard_index = static_cast<size_t>(index);
+                    options.shard_count = static_cast<size_t>(count);
+                }
+                break;
             case 'v':
                 options.verbose_output.verbose(true);
                 break;
@@ -144,56 +299,267 @@ int main(int argc, char* argv[]) {
         exit(1);
     }
 
+    if (options.resume && options.checkpoint.empty()) {
+        std::cerr << "ERROR: --resume requires --checkpoint.\n";
+        exit(1);
+    }
+    if (options.native_sqlite && options.output_format != "SQlite") {
+        std::cerr << "ERROR: --native-sqlite requires output format SQlite.\n";
+        exit(1);
+    }
+    if (options.spatial_index && options.output_format != "SQlite") {
+        std::cerr << "ERROR: --spatial-index requires output format SQlite.\n";
+        exit(1);
+    }
+    if (!options.checkpoint.empty() && input_filename == "-") {
+        std::cerr << "ERROR: --checkpoint cannot be used if the input is read from standard input.\n";
+        exit(1);
+    }
+
+    // A process started with --shard K/N never spawns processes itself.
+    if (options.spawn_shards > 1 && options.shard_count == 1) {
+        if (input_filename == "-" || remaining_args != 2) {
+            std::cerr << "ERROR: --shards requires INPUT_FILE and OUTPUT_DIRECTORY.\n";
+            exit(1);
+        }
+        if (!options.changes_file.empty()) {
+            std::cerr << "ERROR: --shards cannot be combined with --update.\n";
+            exit(1);
+        }
+        if (options.flatgeobuf()) {
+            // The output of the shards is merged by appending to the files of the first shard.
+            std::cerr << "ERROR: --shards cannot be used with output format FlatGeobuf.\n";
+            exit(1);
+        }
+        if (!options.checkpoint.empty()) {
+            // All shard processes would write the same checkpoint.
+            std::cerr << "ERROR: --shards cannot be combined with --checkpoint.\n";
+            exit(1);
+        }
+        // The shard of a way depends on the location of its first node. Therefore every shard
+        // process needs the locations of all nodes. Without a complete cache, each of them would
+        // read and store all of them (or build the same cache file at the same time).
+        if (options.location_cache.empty()) {
+            std::cerr << "ERROR: --shards requires --location-cache.\n";
+            exit(1);
+        }
+        if (!LocationCache(options.location_cache, input_filename).valid()) {
+            std::cerr << "ERROR: The location cache has to be built by a run without --shards first.\n";
+            exit(1);
+        }
+        std::vector<std::string> child_options {argv + 1, argv + optind};
+        // The output of the shards is merged using OGR. The spatial index is built afterwards.
+        child_options.erase(std::remove(child_options.begin(), child_options.end(), "--spatial-index"),
+                child_options.end());
+        exit(run_shards(argv[0], child_options, input_filename, options));
+    }
+
+    // Output directory of the previous run if it is updated. The new features are written to a
+    // temporary directory first.
+    std::string update_directory;
+    if (!options.changes_file.empty()) {
+        if (input_filename == "-" || remaining_args != 2) {
+            std::cerr << "ERROR: --update requires INPUT_FILE and OUTPUT_DIRECTORY.\n";
+            exit(1);
+        }
+        if (std::find(options.views.begin(), options.views.end(), ViewType::places) != options.views.end()) {
+            std::cerr << "ERROR: --update does not support the places view.\n";
+            exit(1);
+        }
+        if (options.flatgeobuf()) {
+            std::cerr << "ERROR: --update does not support output format FlatGeobuf.\n";
+            exit(1);
+        }
+        update_directory = options.output_directory;
+        std::string tmp_directory = options.output_directory + "/.update-XXXXXX";
+        if (!mkdtemp(&tmp_directory[0])) {
+            std::cerr << "ERROR: Failed to create temporary directory in " << options.output_directory << '\n';
+            exit(1);
+        }
+        options.output_directory = tmp_directory;
+    }
+
+    std::unique_ptr<LocationCache> location_cache;
+    bool location_cache_hit = false;
+    if (!options.location_cache.empty()) {
+        if (input_filename == "-") {
+            std::cerr << "ERROR: --location-cache cannot be used if the input is read from standard input.\n";
+            exit(1);
+        }
+        location_cache.reset(new LocationCache(options.location_cache, input_filename));
+        location_cache_hit = location_cache->valid();
+        if (location_cache_hit) {
+            options.verbose_output << "Using node locations from " << options.location_cache << '\n';
+        } else {
+            options.verbose_output << "Location cache " << options.location_cache << " is missing or outdated, rebuilding it\n";
+            try {
+                location_cache->invalidate();
+            } catch (std::system_error& err) {
+                std::cerr << "ERROR: " << err.what() << '\n';
+                exit(1);
+            }
+        }
+        options.location_index_type = location_cache->index_type();
+    }
+
+    // Standard input can be read only once. If more than one pass reads the input, it is
+    // copied to a temporary file first.
+    std::unique_ptr<InputSpool> input_spool;
+    const bool multiple_passes = options.lazy_locations
+        || std::any_of(options.views.begin(), options.views.end(), [](const ViewType vt) {
+            return vt == ViewType::tagging || vt == ViewType::highways || vt == ViewType::turn_restrictions;
+        });
+    if (input_filename == "-" && multiple_passes) {
+        options.verbose_output << "Copying standard input to a temporary file ...\n";
+        try {
+            input_spool.reset(new InputSpool(options.output_directory));
+        } catch (std::system_error& err) {
+            std::cerr << "ERROR: " << err.what() << '\n';
+            exit(1);
+        }
+        input_filename = input_spool->filename();
+        options.verbose_output << "Reading input from " << input_filename << '\n';
+    }
+
+    std::string index_filename;
+    if (options.max_memory) {
+        index_filename = apply_memory_budget(options, input_filename, !index_type_given && !location_cache);
+    }
+
     const auto& map_factory = osmium::index::MapFactory<osmium::unsigned_object_id_type, osmium::Location>::instance();
     auto location_index = map_factory.create_map(options.location_index_type);
+    if (!index_filename.empty()) {
+        // The index keeps the file open.
+        unlink(index_filename.c_str());
+    }
     location_handler_type location_handler(*location_index);
     location_handler.ignore_errors();
 
     osmium::area::Assembler::config_type assembler_config;
     osmium::area::MultipolygonCollector<osmium::area::Assembler> collector(assembler_config);
     HandlerCollection handlers {options};
+    RunStatistics statistics;
     {
         // This section enclosed by curly braces ensures that any_collector is destroyed and does
         // not use its pointer to a dataset of the TaggingViewHandler when the
         // TaggingViewHandler::close is called.
         int pass_count = 1;
+        std::unique_ptr<ChangeSet> change_set;
         AnyRelationCollector any_collector(options);
         HighwayRelationManager highway_collector(options);
         TurnRestrictionsManager restrictions_manager(options);
 
-        // additional passes for views which use relations
+        if (!options.changes_file.empty()) {
+            options.verbose_output << "Pass " << pass_count << " (Changes) ...\n";
+            statistics.begin_pass("changes");
+            change_set.reset(new ChangeSet());
+            change_set->read_changes(options.changes_file);
+            osmium::io::Reader reader_changes(input_filename,
+                    osmium::osm_entity_bits::way | osmium::osm_entity_bits::relation);
+            ObjectCounter changes_counter;
+            osmium::apply(reader_changes, changes_counter, *change_set);
+            reader_changes.close();
+            statistics.end_pass(changes_counter.count());
+            // Relation managers only collect relations which are affected by the changes.
+            // AnyRelationCollector needs all relations to tell if a way is member of any relation.
+            highway_collector.set_relation_filter(&(change_set->affected_relations()));
+            restrictions_manager.set_relation_filter(&(change_set->affected_relations()));
+            handlers.set_node_filter(&(change_set->changed_nodes()));
+            options.verbose_output << "Pass " << pass_count << " done, "
+                << change_set->changed_nodes().size() << " nodes, "
+                << change_set->affected_ways().size() << " ways and "
+                << change_set->affected_relations().size() << " relations affected\n";
+            ++pass_count;
+        }
+
+        // All views which use relations share a single pass over the relations of the input
+        // file. Each collector/manager only keeps the relations of the view it belongs to.
+        bool relations_required = false;
+        bool any_collector_enabled = false;
         for (auto vt : options.views) {
-            if (vt == ViewType::places) {
-                options.verbose_output << "Pass " << pass_count << " (Multipolygons) ...\n";
-                osmium::io::Reader reader1(input_filename, osmium::osm_entity_bits::relation);
-                reader1.close();
-                options.verbose_output << "Pass " << pass_count << " done\n";
-                ++pass_count;
-            } else if (vt == ViewType::tagging) {
-                options.verbose_output << "Pass " << pass_count << " (Relations (Tagging view)) ...\n";
-                osmium::io::Reader reader1(input_filename, osmium::osm_entity_bits::relation);
-                any_collector.read_relations(reader1);
-                reader1.close();
-                options.verbose_output << "Pass " << pass_count << " done\n";
-                ++pass_count;
+            if (vt == ViewType::tagging) {
+                any_collector.enable();
+                any_collector_enabled = true;
+                relations_required = true;
             } else if (vt == ViewType::highways) {
-                options.verbose_output << "Pass " << pass_count << " (Relations (Highways view)) ...\n";
-                osmium::io::File input_file(input_filename);
                 highway_collector.enable();
-                osmium::relations::read_relations(input_file, highway_collector);
-                options.verbose_output << "Pass " << pass_count << " done\n";
-                ++pass_count;
+                relations_required = true;
             } else if (vt == ViewType::turn_restrictions) {
-                options.verbose_output << "Pass " << pass_count << " (Relations (Turn restictions view)) ...\n";
-                osmium::io::File input_file(input_filename);
-                osmium::relations::read_relations(input_file, restrictions_manager);
-                options.verbose_output << "Pass " << pass_count << " done\n";
-                ++pass_count;
+                restrictions_manager.enable();
+                relations_required = true;
             }
         }
-        options.verbose_output << "Pass " << pass_count << " ...\n";
-
-        osmium::io::Reader reader2(input_filename, osmium::osm_entity_bits::node | osmium::osm_entity_bits::way);
+        if (relations_required) {
+            options.verbose_output << "Pass " << pass_count << " (Relations) ...\n";
+            statistics.begin_pass("relations");
+            osmium::io::File input_file(input_filename);
+            // Only the blocks containing relations are read from sorted PBF files.
+            std::string relation_blocks;
+            if (input_file.format() == osmium::io::file_format::pbf
+                    && input_file.compression() == osmium::io::file_compression::none) {
+                try {
+                    relation_blocks = extract_relation_blocks(input_filename);
+                } catch (std::runtime_error& err) {
+                    std::cerr << "ERROR: " << err.what() << '\n';
+                    exit(1);
+                }
+                if (relation_blocks.empty()) {
+                    options.verbose_output << "Input file is not sorted or uses an unsupported compression,"
+                        " reading all blocks\n";
+                } else {
+                    options.verbose_output << "Reading " << relation_blocks.size() / 1024
+                        << " kB of blocks containing relations\n";
+                    input_file = osmium::io::File{relation_blocks.data(), relation_blocks.size(), "pbf"};
+                }
+            }
+            auto any_collector_handler = any_collector.first_pass_handler();
+            ObjectCounter relations_counter;
+            if (options.checkpoint.empty()) {
+                osmium::relations::read_relations(input_file, relations_counter, any_collector_handler,
+                        highway_collector, restrictions_manager);
+            } else {
+                // The selection of relations depends on the views, the shard and the changes.
+                std::string settings = "views=";
+                for (auto vt : options.views) {
+                    settings += std::to_string(static_cast<int>(vt));
+                    settings += ',';
+                }
+                settings += " shard=" + std::to_string(options.shard_index) + "/"
+                        + std::to_string(options.shard_count);
+                if (!options.changes_file.empty()) {
+                    settings += " changes=" + input_fingerprint(options.changes_file);
+                }
+                RelationCheckpoint checkpoint {options.checkpoint, input_filename, settings};
+                if (options.resume && checkpoint.valid()) {
+                    options.verbose_output << "Reading relations from checkpoint " << options.checkpoint << '\n';
+                    osmium::relations::read_relations(checkpoint.file(), relations_counter,
+                            any_collector_handler, highway_collector, restrictions_manager);
+                } else {
+                    if (options.resume) {
+                        options.verbose_output << "Checkpoint " << options.checkpoint
+                            << " is missing or outdated, reading relations from input file\n";
+                    }
+                    // Removing or writing the checkpoint fails e.g. if the disk is full.
+                    try {
+                        checkpoint.invalidate();
+                        RelationCheckpoint::Recorder recorder {checkpoint, [&](const osmium::Relation& relation) {
+                            return (any_collector_enabled && any_collector.keep_relation(relation))
+                                || highway_collector.new_relation(relation)
+                                || restrictions_manager.new_relation(relation);
+                        }};
+                        osmium::relations::read_relations(input_file, relations_counter, any_collector_handler,
+                                highway_collector, restrictions_manager, recorder);
+                        checkpoint.commit();
+                    } catch (std::system_error& err) {
+                        std::cerr << "ERROR: " << err.what() << '\n';
+                        exit(1);
+                    }
+                }
+            }
+            statistics.end_pass(relations_counter.count());
+            options.verbose_output << "Pass " << pass_count << " done\n";
+            ++pass_count;
+        }
         for (auto vt : options.views) {
             if (vt == ViewType::tagging) {
                 handlers.add_handler(vt);
@@ -210,16 +576,163 @@ int main(int argc, char* argv[]) {
                 handlers.add_multipolygon_collector(collector);
             }
         }
+        try {
+            handlers.open_writers();
+        } catch (std::runtime_error& err) {
+            std::cerr << "ERROR: " << err.what() << '\n';
+            exit(1);
+        }
+
+        // Ways which will produce output and the nodes referenced by them
+        id_set_type wanted_ways;
+        id_set_type needed_nodes;
+        // If all views depend on ways with certain keys only, we do not need the locations of
+        // all other nodes. This cheap prefilter is superseded by --lazy-locations.
+        // The location cache has to contain all nodes for later runs with other views.
+        // Standard input which has not been spooled can be read only once.
+        const bool key_prefilter = !options.lazy_locations && options.location_cache.empty()
+                && !change_set && input_filename != "-" && handlers.limited_by_keys();
+        if (options.lazy_locations || key_prefilter || change_set) {
+            options.verbose_output << "Pass " << pass_count << " (Selecting ways) ...\n";
+            statistics.begin_pass("selection");
+            size_t selection_count = 0;
+            // relation members are added to wanted_ways
+            handlers.add_relation_member_ways(wanted_ways);
+            osmium::io::Reader reader_selection(input_filename, osmium::osm_entity_bits::way);
+            while (osmium::memory::Buffer buffer = reader_selection.read()) {
+                for (const osmium::Way& way : buffer.select<osmium::Way>()) {
+                    ++selection_count;
+                    bool selected = wanted_ways.get(way.positive_id());
+                    // In update mode, only ways affected by the changes are processed.
+                    if (!selected && (!change_set || change_set->affected_ways().get(way.positive_id()))) {
+                        if (key_prefilter) {
+                            selected = handlers.way_has_relevant_keys(way);
+                        } else {
+                            selected = !options.lazy_locations || handlers.way_produces_output(way);
+                            if (selected) {
+                                wanted_ways.set(way.positive_id());
+                            }
+                        }
+                    }
+                    if (selected) {
+                        for (const osmium::NodeRef& nr : way.nodes()) {
+                            needed_nodes.set(nr.positive_ref());
+                        }
+                    }
+                }
+            }
+            reader_selection.close();
+            statistics.end_pass(selection_count);
+            if (options.lazy_locations || change_set) {
+                handlers.set_way_filter(&wanted_ways);
+                options.verbose_output << "Pass " << pass_count << " done, " << wanted_ways.size()
+                    << " ways and " << needed_nodes.size() << " nodes selected\n";
+            } else {
+                options.verbose_output << "Pass " << pass_count << " done, " << needed_nodes.size()
+                    << " nodes selected\n";
+            }
+            ++pass_count;
+        }
 
-        osmium::apply(reader2, location_handler, handlers);
+        options.verbose_output << "Pass " << pass_count << " ...\n";
+        statistics.begin_pass("nodes and ways");
+        osmium::io::Reader reader2(input_filename, osmium::osm_entity_bits::node | osmium::osm_entity_bits::way);
+        ObjectCounter main_counter;
+        auto main_pass = [&](auto& loc_handler) {
+            if (options.threads > 1) {
+                // The location handler runs on this thread, the views run on the worker threads.
+                ViewWorkerPool pool {handlers, options.views, options.threads, options.worker_queue_size};
+                while (osmium::memory::Buffer buffer = reader2.read()) {
+                    osmium::apply(buffer, main_counter, loc_handler);
+                    pool.push(std::move(buffer));
+                }
+                pool.finish();
+            } else {
+                while (osmium::memory::Buffer buffer = reader2.read()) {
+                    osmium::apply(buffer, main_counter, loc_handler);
+                    handlers.apply_buffer(buffer);
+                }
+            }
+        };
+        if (location_cache_hit) {
+            // All locations are available already. Nodes are not added to the index again.
+            const id_set_type no_nodes;
+            SelectiveNodeLocations<location_handler_type> lookup_only_handler {location_handler,
+                    no_nodes, (options.lazy_locations || change_set) ? &wanted_ways : nullptr};
+            main_pass(lookup_only_handler);
+        } else if (location_cache) {
+            // Fill the cache completely.
+            main_pass(location_handler);
+        } else if (options.lazy_locations || change_set) {
+            SelectiveNodeLocations<location_handler_type> selective_location_handler {location_handler,
+                    needed_nodes, &wanted_ways};
+            main_pass(selective_location_handler);
+        } else if (key_prefilter) {
+            SelectiveNodeLocations<location_handler_type> selective_location_handler {location_handler,
+                    needed_nodes};
+            main_pass(selective_location_handler);
+        } else {
+            main_pass(location_handler);
+        }
         reader2.close();
+        statistics.end_pass(main_counter.count(), location_index->size(), location_index->used_memory());
+        if (location_cache && !location_cache_hit) {
+            try {
+                location_cache->commit();
+            } catch (std::system_error& err) {
+                std::cerr << "ERROR: " << err.what() << '\n';
+                exit(1);
+            }
+        }
         options.verbose_output << "Pass " << pass_count << " done\n";
         if (std::find(options.views.begin(), options.views.end(), ViewType::highways) != options.views.end()) {
             highway_collector.for_each_incomplete_relation([&](const osmium::relations::RelationHandle& handle){
                 highway_collector.process_relation(*handle);
             });
         }
-        handlers.give_correct_name();
+        try {
+            // rethrows the errors of the writer threads
+            handlers.give_correct_name();
+        } catch (std::runtime_error& err) {
+            std::cerr << "ERROR: " << err.what() << '\n';
+            exit(1);
+        }
+        handlers.add_statistics(statistics);
+        if (options.check_counters) {
+            handlers.print_check_counters(std::cerr);
+        }
+
+        if (change_set) {
+            // Replace the features of all processed objects and of deleted objects.
+            auto replaced = [&](const osmium::item_type type, const osmium::object_id_type id) {
+                const osmium::unsigned_object_id_type positive_id = std::abs(id);
+                switch (type) {
+                case osmium::item_type::node:
+                    return change_set->changed_nodes().get(positive_id);
+                case osmium::item_type::way:
+                    return wanted_ways.get(positive_id) || change_set->affected_ways().get(positive_id);
+                case osmium::item_type::relation:
+                    return change_set->affected_relations().get(positive_id);
+                default:
+                    return false;
+                }
+            };
+            try {
+                merge_directory(options.output_directory, update_directory, replaced, options.verbose_output);
+            } catch (std::runtime_error& err) {
+                std::cerr << "ERROR: " << err.what() << '\n';
+                std::cerr << "The new features are kept in " << options.output_directory << '\n';
+                exit(1);
+            }
+        }
     }
 
+    if (!options.stats_file.empty()) {
+        try {
+            statistics.write(options.stats_file);
+        } catch (std::runtime_error& err) {
+            std::cerr << "ERROR: " << err.what() << '\n';
+            exit(1);
+        }
+    }
 }
@@ -0,0 +1,288 @@
+/*
+ * output_feature.hpp
+ *
+ *  Created on:  2026-10-18
+ */
+
+#ifndef SRC_OUTPUT_FEATURE_HPP_
+#define SRC_OUTPUT_FEATURE_HPP_
+
+#include <cstring>
+#include <memory>
+#include <new>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include <strings.h>
+
+#include <gdalcpp.hpp>
+
+/**
+ * Name and fields of an output layer captured from its definition.
+ *
+ * If a layer is written by a FeatureWriter (writer threads or the native SpatiaLite writer),
+ * the handler producing its features must not read the layer definition anymore.
+ * HandlerCollection::open_writers captures the fields of these layers before the first
+ * feature is written.
+ */
+class LayerFields {
+    std::string m_name;
+
+    /// names of the fields in the order of the layer definition
+    std::vector<std::string> m_fields;
+
+public:
+    explicit LayerFields(gdalcpp::Layer& layer) :
+        m_name(layer.name()),
+        m_fields() {
+        OGRFeatureDefn* definition = layer.get().GetLayerDefn();
+        for (int i = 0; i < definition->GetFieldCount(); ++i) {
+            m_fields.emplace_back(definition->GetFieldDefn(i)->GetNameRef());
+        }
+    }
+
+    const std::string& name() const noexcept {
+        return m_name;
+    }
+
+    /**
+     * Get the index of a field. Like OGRFeatureDefn::GetFieldIndex, the case of the names is
+     * ignored.
+     *
+     * \returns -1 if the layer has no such field
+     */
+    int index(const char* field) const noexcept {
+        for (size_t i = 0; i < m_fields.size(); ++i) {
+            if (!strcasecmp(m_fields[i].c_str(), field)) {
+                return static_cast<int>(i);
+            }
+        }
+        return -1;
+    }
+};
+
+/// captured fields of each layer written by a FeatureWriter
+using layer_fields_map = std::unordered_map<const gdalcpp::Layer*, LayerFields>;
+
+/**
+ * Feature to be written to an output layer.
+ *
+ * This class provides the same interface as gdalcpp::Feature. If the layer of the feature
+ * is written using OGR by OGROutputBase::write_feature (the default), the geometry and the
+ * fields are set on an OGRFeature right away like gdalcpp::Feature does.
+ *
+ * If the layer is written by a FeatureWriter (see set_layer_fields()), the feature is queued
+ * or written without OGR. Then it keeps the geometry and a copy of the field values
+ * (addressed by the index of the field in the layer definition) instead.
+ */
+class OutputFeature {
+public:
+    struct Field {
+        enum class Type : char {
+            integer = 0,
+            integer64 = 1,
+            string = 2
+        };
+
+        int index;
+        Type type;
+        GIntBig integer;
+        /// position of the value of a string field in the string buffer of the feature
+        size_t offset;
+        size_t length;
+    };
+
+private:
+    struct OGRFeatureDeleter {
+        void operator()(OGRFeature* feature) const {
+            OGRFeature::DestroyFeature(feature);
+        }
+    };
+
+    /// captured fields of the layers written by a FeatureWriter, see set_layer_fields()
+    inline static const layer_fields_map* m_layer_fields = nullptr;
+
+    gdalcpp::Layer* m_layer = nullptr;
+
+    /// OGR feature if the feature is written using OGR directly, nullptr otherwise
+    std::unique_ptr<OGRFeature, OGRFeatureDeleter> m_feature;
+
+    /// captured fields of the layer if the feature is passed to a FeatureWriter
+    const LayerFields* m_captured_fields = nullptr;
+
+    std::unique_ptr<OGRGeometry> m_geometry;
+
+    std::vector<Field> m_fields;
+
+    /// values of the string fields, each one terminated by a null character
+    std::string m_strings;
+
+    OGRFeature* create_ogr_feature(std::unique_ptr<OGRGeometry>&& geometry) const {
+        OGRFeature* feature = OGRFeature::CreateFeature(m_layer->get().GetLayerDefn());
+        if (!feature) {
+            throw std::bad_alloc{};
+        }
+        const OGRErr result = feature->SetGeometryDirectly(geometry.release());
+        if (result != OGRERR_NONE) {
+            OGRFeature::DestroyFeature(feature);
+            throw gdalcpp::gdal_error{std::string{"setting feature geometry in layer '"}
+                + m_layer->name() + "' failed", result};
+        }
+        return feature;
+    }
+
+    void add_field(const char* field, const Field::Type type, const GIntBig integer) {
+        const int index = m_captured_fields->index(field);
+        if (index >= 0) {
+            m_fields.push_back(Field{index, type, integer, 0, 0});
+        }
+    }
+
+    void add_string_field(const char* field, const char* value) {
+        const int index = m_captured_fields->index(field);
+        if (index >= 0) {
+            const size_t length = std::strlen(value);
+            m_fields.push_back(Field{index, Field::Type::string, 0, m_strings.size(), length});
+            m_strings.append(value, length + 1);
+        }
+    }
+
+public:
+    /**
+     * Create an empty feature without a layer. It must not be written.
+     */
+    OutputFeature() = default;
+
+    /**
+     * \throws gdalcpp::gdal_error
+     */
+    OutputFeature(gdalcpp::Layer& layer, std::unique_ptr<OGRGeometry>&& geometry) :
+        m_layer(&layer),
+        m_feature(),
+        m_geometry(),
+        m_fields(),
+        m_strings() {
+        if (m_layer_fields) {
+            auto it = m_layer_fields->find(&layer);
+            if (it != m_layer_fields->end()) {
+                m_captured_fields = &(it->second);
+                m_geometry = std::move(geometry);
+                return;
+            }
+        }
+        m_feature.reset(create_ogr_feature(std::move(geometry)));
+    }
+
+    /**
+     * Set the captured fields of the layers written by a FeatureWriter. Features of these
+     * layers keep a copy of their fields and look up the fields there instead of reading
+     * the layer definition. All other features are built as OGR features.
+     *
+     * \param layer_fields map of layers and their fields (has to outlive all features of these
+     *        layers), nullptr to build all features as OGR features again
+     */
+    static void set_layer_fields(const layer_fields_map* layer_fields) noexcept {
+        m_layer_fields = layer_fields;
+    }
+
+    bool valid() const noexcept {
+        return m_layer != nullptr;
+    }
+
+    gdalcpp::Layer& layer() noexcept {
+        return *m_layer;
+    }
+
+    /**
+     * Captured fields of the layer, nullptr if the feature is built as an OGR feature.
+     */
+    const LayerFields* captured_fields() const noexcept {
+        return m_captured_fields;
+    }
+
+    /**
+     * Geometry of a feature passed to a FeatureWriter.
+     */
+    const OGRGeometry* geometry() const noexcept {
+        return m_geometry.get();
+    }
+
+    /**
+     * Fields of a feature passed to a FeatureWriter.
+     */
+    const std::vector<Field>& fields() const noexcept {
+        return m_fields;
+    }
+
+    /**
+     * Value of a string field of a feature passed to a FeatureWriter (null-terminated).
+     */
+    const char* string_value(const Field& field) const noexcept {
+        return m_strings.data() + field.offset;
+    }
+
+    /**
+     * Set a field. Fields missing in the layer definition are ignored like
+     * OGRFeature::SetField does. A null value leaves the field unset.
+     */
+    OutputFeature& set_field(const char* field, const char* value) {
+        if (!value) {
+            return *this;
+        }
+        if (m_feature) {
+            m_feature->SetField(field, value);
+        } else {
+            add_string_field(field, value);
+        }
+        return *this;
+    }
+
+    OutputFeature& set_field(const char* field, const int value) {
+        if (m_feature) {
+            m_feature->SetField(field, value);
+        } else {
+            add_field(field, Field::Type::integer, value);
+        }
+        return *this;
+    }
+
+    OutputFeature& set_field(const char* field, const GIntBig value) {
+        if (m_feature) {
+            m_feature->SetField(field, value);
+        } else {
+            add_field(field, Field::Type::integer64, value);
+        }
+        return *this;
+    }
+
+    /**
+     * Write the feature to its layer using OGR.
+     *
+     * \throws gdalcpp::gdal_error
+     */
+    void write_to_layer() {
+        if (m_feature) {
+            m_layer->create_feature(m_feature.get());
+            return;
+        }
+        std::unique_ptr<OGRFeature, OGRFeatureDeleter> feature {create_ogr_feature(std::move(m_geometry))};
+        for (const Field& field : m_fields) {
+            switch (field.type) {
+            case Field::Type::integer:
+                feature->SetField(field.index, static_cast<int>(field.integer));
+                break;
+            case Field::Type::integer64:
+                feature->SetField(field.index, field.integer);
+                break;
+            case Field::Type::string:
+                feature->SetField(field.index, string_value(field));
+                break;
+            }
+        }
+        m_layer->create_feature(feature.get());
+    }
+};
+
+#endif /* SRC_OUTPUT_FEATURE_HPP_ */
@@ -19,6 +19,7 @@
 
 
 #include "places_handler.hpp"
+#include "tag_digest.hpp"
 #include <iostream>
 #include <osmium/index/index.hpp>
 #include <osmium/osm/item_type.hpp>
@@ -214,7 +215,7 @@ void PlacesHandler::add_feature(std::unique_ptr<OGRGeometry>&& geometry, const o
     if (city_layer) {
         current_layer = m_cities.get();
     }
-    gdalcpp::Feature feature(*current_layer, std::move(geometry));
+    OutputFeature feature(*current_layer, std::move(geometry));
     set_basic_fields(feature, osm_object, id);
 
     // place and type field
@@ -273,10 +274,10 @@ void PlacesHandler::add_feature(std::unique_ptr<OGRGeometry>&& geometry, const o
     } else {
         add_error(osm_object, id, geomtype, "place_without_name");
     }
-    feature.add_to_layer();
+    write_feature(feature);
 }
 
-void PlacesHandler::set_basic_fields(gdalcpp::Feature& feature, const osmium::OSMObject& osm_object,
+void PlacesHandler::set_basic_fields(OutputFeature& feature, const osmium::OSMObject& osm_object,
         const osmium::object_id_type id) {
     static char idbuffer[20];
     sprintf(idbuffer, "%ld", id);
@@ -301,7 +302,7 @@ void PlacesHandler::add_error(const osmium::OSMObject& osm_object, const osmium:
     default:
         return;
     }
-    gdalcpp::Feature the_feature(*error_layer, std::move(geometry));
+    OutputFeature the_feature(*error_layer, std::move(geometry));
     set_basic_fields(the_feature, osm_object, id);
     the_feature.set_field("error", error.c_str());
     if (different_value == "") {
@@ -310,11 +311,20 @@ void PlacesHandler::add_error(const osmium::OSMObject& osm_object, const osmium:
         the_feature.set_field("value", different_value.c_str());
     }
     the_feature.set_field("geomtype", geomtype);
-    the_feature.add_to_layer();
+    write_feature(the_feature);
+}
+
+key_mask_type PlacesHandler::node_key_interest() const {
+    return key_bit(TagKey::place);
+}
+
+key_mask_type PlacesHandler::way_key_interest() const {
+    // Places are built from nodes and areas only.
+    return 0;
 }
 
 void PlacesHandler::node(const osmium::Node& node) {
-    const char* place = node.get_value_by_key("place");
+    const char* place = TagDigest::value(node.tags(), TagKey::place);
     if (place && coordinates_valid(node)) {
         add_feature(m_factory.create_point(node), node, "n", node.id(), place);
         if (!strcmp(place, "city")) {
@@ -346,12 +356,12 @@ void PlacesHandler::area(const osmium::Area& area) {
             if (centroid_error == OGRERR_NONE) {
                 add_feature(std::unique_ptr<OGRPoint>(std::move(centroid_point)), area, geomtype.c_str(), area.orig_id(), place, true);
             } else {
-                m_options.verbose_output << "Error creating centroid for area " << area.id() << ": " << centroid_error << "\n";
+                log_verbose(m_options.verbose_output, "Error creating centroid for area ", area.id(), ": ", centroid_error, "\n");
             }
         }
     } catch (osmium::geometry_error& err) {
-        m_options.verbose_output << err.what();
+        log_verbose(m_options.verbose_output, err.what());
     } catch (osmium::not_found& err) {
-        m_options.verbose_output << err.what();
+        log_verbose(m_options.verbose_output, err.what());
     }
 }
@@ -25,7 +25,7 @@
 
 #include "abstract_view_handler.hpp"
 
-class PlacesHandler : public AbstractViewHandler {
+class PlacesHandler final : public AbstractViewHandler {
 
     std::unique_ptr<gdalcpp::Layer> m_points;
     std::unique_ptr<gdalcpp::Layer> m_polygons;
@@ -68,7 +68,7 @@ class PlacesHandler : public AbstractViewHandler {
      * \param osm_object OSM object to be written
      * \param id ID of the OSM object
      */
-    void set_basic_fields(gdalcpp::Feature& feature, const osmium::OSMObject& osm_object,
+    void set_basic_fields(OutputFeature& feature, const osmium::OSMObject& osm_object,
             const osmium::object_id_type id);
 
     /**
@@ -101,6 +101,10 @@ public:
 
     void close();
 
+    key_mask_type node_key_interest() const;
+
+    key_mask_type way_key_interest() const;
+
     void node(const osmium::Node& node);
 
     void area(const osmium::Area& area);
@@ -0,0 +1,245 @@
+/*
+ * relation_blocks.cpp
+ *
+ *  Created on:  2026-10-18
+ */
+
+#include <cstdint>
+#include <fstream>
+#include <iterator>
+#include <stdexcept>
+#include <vector>
+
+#include <protozero/pbf_reader.hpp>
+#include <zlib.h>
+
+#include "relation_blocks.hpp"
+
+namespace {
+
+    /// maximum size of a BlobHeader according to the PBF specification
+    constexpr uint32_t max_blob_header_size = 64 * 1024;
+
+    /// maximum uncompressed size of a Blob according to the PBF specification
+    constexpr int32_t max_uncompressed_blob_size = 32 * 1024 * 1024;
+
+    /**
+     * Position of a blob in the file. The range includes the length prefix and the
+     * BlobHeader.
+     */
+    struct BlobPosition {
+        std::streamoff offset;
+        std::streamoff size;
+        std::streamoff data_offset;
+        int32_t data_size;
+        bool osm_data;
+    };
+
+    enum class BlockContent {
+        relations_only,
+        mixed,
+        no_relations,
+        unknown
+    };
+
+    std::vector<BlobPosition> scan_blob_headers(std::ifstream& input, const std::string& filename) {
+        std::vector<BlobPosition> blobs;
+        std::streamoff offset = 0;
+        unsigned char size_bytes[4];
+        while (input.read(reinterpret_cast<char*>(size_bytes), sizeof(size_bytes))) {
+            const uint32_t header_size = (static_cast<uint32_t>(size_bytes[0]) << 24)
+                | (static_cast<uint32_t>(size_bytes[1]) << 16)
+                | (static_cast<uint32_t>(size_bytes[2]) << 8) | size_bytes[3];
+            if (header_size > max_blob_header_size) {
+                throw std::runtime_error{filename + " is not a valid PBF file (BlobHeader too large)"};
+            }
+            std::string header(header_size, '\0');
+            if (!input.read(&header[0], header_size)) {
+                throw std::runtime_error{"Unexpected end of " + filename};
+            }
+            BlobPosition blob {offset, 0, offset + 4 + header_size, -1, false};
+            protozero::pbf_reader blob_header {header};
+            while (blob_header.next()) {
+                switch (blob_header.tag()) {
+                case 1: // type
+                    blob.osm_data = (blob_header.get_string() == "OSMData");
+                    break;
+                case 3: // datasize
+                    blob.data_size = blob_header.get_int32();
+                    break;
+                default:
+                    blob_header.skip();
+                }
+            }
+            if (blob.data_size < 0) {
+                throw std::runtime_error{filename + " is not a valid PBF file (BlobHeader without size)"};
+            }
+            blob.size = 4 + header_size + blob.data_size;
+            blobs.push_back(blob);
+            offset += blob.size;
+            input.seekg(offset);
+        }
+        if (!input.eof()) {
+            throw std::runtime_error{"Failed to read " + filename};
+        }
+        input.clear();
+        return blobs;
+    }
+
+    /**
+     * Read a range of the file and append it to output.
+     */
+    void append_range(std::ifstream& input, const std::streamoff offset, const std::streamoff size,
+            const std::string& filename, std::string& output) {
+        const size_t old_size = output.size();
+        output.resize(old_size + static_cast<size_t>(size));
+        input.seekg(offset);
+        if (!input.read(&output[old_size], size)) {
+            throw std::runtime_error{"Unexpected end of " + filename};
+        }
+    }
+
+    std::string read_range(std::ifstream& input, const std::streamoff offset, const std::streamoff size,
+            const std::string& filename) {
+        std::string data;
+        append_range(input, offset, size, filename, data);
+        return data;
+    }
+
+    /**
+     * Decompress a Blob.
+     *
+     * \returns false if the compression is not supported
+     */
+    bool decompress_blob(const std::string& blob_data, std::string& output) {
+        protozero::pbf_reader blob {blob_data};
+        int32_t raw_size = -1;
+        protozero::data_view zlib_data;
+        bool zlib_compressed = false;
+        while (blob.next()) {
+            switch (blob.tag()) {
+            case 1: // raw
+                {
+                    const auto raw = blob.get_view();
+                    output.assign(raw.data(), raw.size());
+                    return true;
+                }
+            case 2: // raw_size
+                raw_size = blob.get_int32();
+                break;
+            case 3: // zlib_data
+                zlib_data = blob.get_view();
+                zlib_compressed = true;
+                break;
+            default:
+                // LZMA, LZ4 and Zstandard are rare. The caller reads the whole file instead.
+                blob.skip();
+            }
+        }
+        if (!zlib_compressed || raw_size < 0 || raw_size > max_uncompressed_blob_size) {
+            return false;
+        }
+        output.resize(static_cast<size_t>(raw_size));
+        uLongf length = static_cast<uLongf>(raw_size);
+        if (uncompress(reinterpret_cast<Bytef*>(&output[0]), &length,
+                reinterpret_cast<const Bytef*>(zlib_data.data()), static_cast<uLong>(zlib_data.size())) != Z_OK
+                || length != static_cast<uLongf>(raw_size)) {
+            return false;
+        }
+        return true;
+    }
+
+    /**
+     * Check if the HeaderBlock announces that the file is sorted by type and ID.
+     */
+    bool sorted_by_type_then_id(const std::string& header_block) {
+        protozero::pbf_reader header {header_block};
+        while (header.next(5)) { // optional_features
+            if (header.get_string() == "Sort.Type_then_ID") {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    BlockContent primitive_block_content(const std::string& primitive_block) {
+        bool relations = false;
+        bool others = false;
+        protozero::pbf_reader block {primitive_block};
+        while (block.next(2)) { // primitivegroup
+            protozero::pbf_reader group {block.get_message()};
+            while (group.next()) {
+                // 1 = nodes, 2 = dense nodes, 3 = ways, 4 = relations, 5 = changesets
+                if (group.tag() == 4) {
+                    relations = true;
+                } else {
+                    others = true;
+                }
+                group.skip();
+            }
+        }
+        if (relations) {
+            return others ? BlockContent::mixed : BlockContent::relations_only;
+        }
+        return BlockContent::no_relations;
+    }
+
+    BlockContent blob_content(std::ifstream& input, const BlobPosition& blob, const std::string& filename) {
+        std::string block;
+        if (!decompress_blob(read_range(input, blob.data_offset, blob.data_size, filename), block)) {
+            return BlockContent::unknown;
+        }
+        return primitive_block_content(block);
+    }
+
+} // namespace
+
+std::string extract_relation_blocks(const std::string& filename) {
+    std::ifstream input {filename, std::ios::binary};
+    if (!input) {
+        throw std::runtime_error{"Failed to open " + filename};
+    }
+    const std::vector<BlobPosition> blobs = scan_blob_headers(input, filename);
+    if (blobs.empty() || blobs.front().osm_data) {
+        throw std::runtime_error{filename + " is not a valid PBF file (OSMHeader missing)"};
+    }
+    const BlobPosition& header_blob = blobs.front();
+    std::string header_block;
+    if (!decompress_blob(read_range(input, header_blob.data_offset, header_blob.data_size, filename), header_block)
+            || !sorted_by_type_then_id(header_block)) {
+        return "";
+    }
+
+    // Relations are stored at the end of a sorted file. The first block of the range may
+    // contain ways as well. Blobs of other types than OSMData are not copied.
+    std::vector<const BlobPosition*> relation_blobs;
+    for (auto it = blobs.rbegin(); it != std::prev(blobs.rend()); ++it) {
+        if (!it->osm_data) {
+            continue;
+        }
+        const BlockContent content = blob_content(input, *it, filename);
+        if (content == BlockContent::unknown) {
+            return "";
+        }
+        if (content == BlockContent::no_relations) {
+            break;
+        }
+        relation_blobs.push_back(&*it);
+        if (content == BlockContent::mixed) {
+            break;
+        }
+    }
+
+    // The blobs are read into their final place. The result is allocated only once.
+    std::streamoff total_size = header_blob.size;
+    for (const BlobPosition* blob : relation_blobs) {
+        total_size += blob->size;
+    }
+    std::string result;
+    result.reserve(static_cast<size_t>(total_size));
+    append_range(input, header_blob.offset, header_blob.size, filename, result);
+    for (auto it = relation_blobs.rbegin(); it != relation_blobs.rend(); ++it) {
+        append_range(input, (*it)->offset, (*it)->size, filename, result);
+    }
+    return result;
+}
@@ -0,0 +1,31 @@
+/*
+ * relation_blocks.hpp
+ *
+ *  Created on:  2026-10-18
+ */
+
+#ifndef SRC_RELATION_BLOCKS_HPP_
+#define SRC_RELATION_BLOCKS_HPP_
+
+#include <string>
+
+/**
+ * Copy the blocks of a PBF file which contain relations into a new PBF stream.
+ *
+ * The relations of a file sorted by type and ID (header feature Sort.Type_then_ID) are
+ * stored in the last blocks of the file. Only the small blob headers are read to find the
+ * blocks. The blocks are decompressed from the end of the file backwards until the first
+ * block without relations is found. The OSMHeader block and the relation blocks are copied
+ * without being decompressed again. The result can be read using
+ * osmium::io::File{data, size, "pbf"}.
+ *
+ * \param filename path to the input file
+ *
+ * \returns PBF data containing all relations of the file, empty if the file is not a
+ * sorted PBF file or a block cannot be decoded (the whole file has to be read then)
+ *
+ * \throws std::runtime_error if the file cannot be read or is not a valid PBF file
+ */
+std::string extract_relation_blocks(const std::string& filename);
+
+#endif /* SRC_RELATION_BLOCKS_HPP_ */
@@ -0,0 +1,78 @@
+/*
+ * relation_checkpoint.cpp
+ *
+ *  Created on:  2026-10-18
+ */
+
+#include <cerrno>
+#include <fstream>
+#include <system_error>
+#include <unistd.h>
+
+#include <osmium/io/pbf_output.hpp>
+
+#include "input_fingerprint.hpp"
+#include "relation_checkpoint.hpp"
+
+RelationCheckpoint::Recorder::Recorder(const RelationCheckpoint& checkpoint, keep_func_type keep) :
+        m_writer(checkpoint.file(), osmium::io::overwrite::allow),
+        m_keep(std::move(keep)) {
+}
+
+void RelationCheckpoint::Recorder::relation(const osmium::Relation& relation) {
+    if (m_keep(relation)) {
+        m_writer(relation);
+    }
+}
+
+void RelationCheckpoint::Recorder::prepare_for_lookup() {
+    m_writer.close();
+}
+
+RelationCheckpoint::RelationCheckpoint(const std::string& checkpoint_filename,
+        const std::string& input_filename, const std::string& settings) :
+        m_filename(checkpoint_filename),
+        m_fingerprint(input_fingerprint(input_filename)) {
+    if (!m_fingerprint.empty()) {
+        m_fingerprint += ' ';
+        m_fingerprint += settings;
+    }
+}
+
+std::string RelationCheckpoint::meta_filename() const {
+    return m_filename + ".meta";
+}
+
+osmium::io::File RelationCheckpoint::file() const {
+    return osmium::io::File{m_filename, "pbf"};
+}
+
+bool RelationCheckpoint::valid() const {
+    if (m_fingerprint.empty() || access(m_filename.c_str(), R_OK) != 0) {
+        return false;
+    }
+    std::ifstream meta {meta_filename()};
+    std::string stored_fingerprint;
+    if (!meta || !std::getline(meta, stored_fingerprint)) {
+        return false;
+    }
+    return stored_fingerprint == m_fingerprint;
+}
+
+void RelationCheckpoint::invalidate() {
+    // Remove the meta file first. A checkpoint without a meta file is never used.
+    for (const std::string& path : {meta_filename(), m_filename}) {
+        if (unlink(path.c_str()) != 0 && errno != ENOENT) {
+            throw std::system_error{errno, std::system_category(), "Failed to remove " + path};
+        }
+    }
+}
+
+void RelationCheckpoint::commit() {
+    std::ofstream meta {meta_filename(), std::ios::trunc};
+    meta << m_fingerprint << '\n';
+    meta.close();
+    if (!meta) {
+        throw std::system_error{errno, std::system_category(), "Failed to write " + meta_filename()};
+    }
+}
@@ -0,0 +1,101 @@
+/*
+ * relation_checkpoint.hpp
+ *
+ *  Created on:  2026-10-18
+ */
+
+#ifndef SRC_RELATION_CHECKPOINT_HPP_
+#define SRC_RELATION_CHECKPOINT_HPP_
+
+#include <functional>
+#include <string>
+
+#include <osmium/handler.hpp>
+#include <osmium/io/file.hpp>
+#include <osmium/io/writer.hpp>
+#include <osmium/osm/relation.hpp>
+
+/**
+ * Checkpoint of the relation pass persisted on disk.
+ *
+ * The checkpoint is an OSM PBF file containing all relations kept by any relation collector
+ * or manager. Reading it instead of the input file restores the state of the collectors and
+ * managers after the relation pass because they apply the same filters again.
+ *
+ * A second file (checkpoint file name + ".meta") contains the fingerprint of the input file
+ * and a description of the settings affecting the selection of the relations. It is written
+ * after the checkpoint has been completed. A checkpoint without a matching meta file is
+ * considered invalid.
+ */
+class RelationCheckpoint {
+
+    std::string m_filename;
+
+    std::string m_fingerprint;
+
+    std::string meta_filename() const;
+
+public:
+    using keep_func_type = std::function<bool(const osmium::Relation&)>;
+
+    /**
+     * Handler writing relations to the checkpoint during the relation pass.
+     *
+     * It can be passed to osmium::relations::read_relations together with the relation
+     * managers.
+     */
+    class Recorder : public osmium::handler::Handler {
+        osmium::io::Writer m_writer;
+        keep_func_type m_keep;
+
+    public:
+        /**
+         * \param checkpoint checkpoint to write
+         * \param keep function returning true for all relations to be written
+         */
+        Recorder(const RelationCheckpoint& checkpoint, keep_func_type keep);
+
+        void relation(const osmium::Relation& relation);
+
+        /**
+         * Close the checkpoint file (read_relations calls it for us).
+         */
+        void prepare_for_lookup();
+    };
+
+    RelationCheckpoint() = delete;
+
+    /**
+     * \param checkpoint_filename path to the checkpoint file
+     * \param input_filename path to the input file
+     * \param settings description of all settings affecting the selection of relations
+     */
+    RelationCheckpoint(const std::string& checkpoint_filename, const std::string& input_filename,
+            const std::string& settings);
+
+    /**
+     * Return the checkpoint file to be read instead of the input file.
+     */
+    osmium::io::File file() const;
+
+    /**
+     * Check if the checkpoint was written for the current input file and settings.
+     */
+    bool valid() const;
+
+    /**
+     * Remove the checkpoint and its meta file.
+     *
+     * \throws std::system_error if the files exist but cannot be removed
+     */
+    void invalidate();
+
+    /**
+     * Mark the checkpoint as complete.
+     *
+     * \throws std::system_error if the meta file cannot be written
+     */
+    void commit();
+};
+
+#endif /* SRC_RELATION_CHECKPOINT_HPP_ */
@@ -0,0 +1,111 @@
+/*
+ * run_statistics.cpp
+ *
+ *  Created on:  2026-10-18
+ */
+
+#include <fstream>
+#include <stdexcept>
+#include <sys/resource.h>
+
+#include "run_statistics.hpp"
+
+static double seconds(const stats_clock::duration duration) {
+    return std::chrono::duration<double>(duration).count();
+}
+
+static double per_second(const size_t count, const double time) {
+    return time > 0 ? count / time : 0;
+}
+
+static std::string json_string(const std::string& str) {
+    std::string result {'"'};
+    for (const char c : str) {
+        if (c == '"' || c == '\\') {
+            result += '\\';
+            result += c;
+        } else if (static_cast<unsigned char>(c) < 0x20) {
+            result += ' ';
+        } else {
+            result += c;
+        }
+    }
+    result += '"';
+    return result;
+}
+
+void ViewStatistics::add_output(const OutputStatistics& output) {
+    ogr_time += output.ogr_time;
+    for (const auto& layer : output.layers) {
+        features[layer.second.name] += layer.second.features;
+    }
+}
+
+double RunStatistics::cpu_time() {
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    return usage.ru_utime.tv_sec + usage.ru_stime.tv_sec
+        + (usage.ru_utime.tv_usec + usage.ru_stime.tv_usec) / 1000000.0;
+}
+
+long RunStatistics::peak_rss() {
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    return usage.ru_maxrss;
+}
+
+void RunStatistics::begin_pass(const std::string& name) {
+    m_pass_name = name;
+    m_pass_start = stats_clock::now();
+    m_pass_cpu_start = cpu_time();
+}
+
+void RunStatistics::end_pass(const size_t objects, const size_t index_size, const size_t index_memory) {
+    m_passes.push_back(PassStatistics{m_pass_name, seconds(stats_clock::now() - m_pass_start),
+        cpu_time() - m_pass_cpu_start, objects, peak_rss(), index_size, index_memory});
+}
+
+void RunStatistics::add_view(ViewStatistics&& view) {
+    m_views.push_back(std::move(view));
+}
+
+void RunStatistics::write(const std::string& filename) const {
+    std::ofstream out {filename, std::ios::trunc};
+    out << "{\n  \"passes\": [";
+    for (size_t i = 0; i < m_passes.size(); ++i) {
+        const PassStatistics& pass = m_passes.at(i);
+        out << (i ? ",\n" : "\n")
+            << "    {\"name\": " << json_string(pass.name)
+            << ", \"wall_time\": " << pass.wall_time
+            << ", \"cpu_time\": " << pass.cpu_time
+            << ", \"objects\": " << pass.objects
+            << ", \"objects_per_second\": " << per_second(pass.objects, pass.wall_time)
+            << ", \"peak_rss_kb\": " << pass.peak_rss
+            << ", \"location_index_size\": " << pass.index_size
+            << ", \"location_index_memory\": " << pass.index_memory << "}";
+    }
+    out << "\n  ],\n  \"views\": [";
+    for (size_t i = 0; i < m_views.size(); ++i) {
+        const ViewStatistics& view = m_views.at(i);
+        const double handler_time = seconds(view.handler_time);
+        const double ogr_time = seconds(view.ogr_time);
+        out << (i ? ",\n" : "\n")
+            << "    {\"name\": " << json_string(view.name)
+            << ", \"objects\": " << view.objects
+            << ", \"objects_per_second\": " << per_second(view.objects, handler_time + ogr_time)
+            << ", \"handler_time\": " << handler_time
+            << ", \"ogr_time\": " << ogr_time
+            << ", \"features\": {";
+        bool first = true;
+        for (const auto& layer : view.features) {
+            out << (first ? "" : ", ") << json_string(layer.first) << ": " << layer.second;
+            first = false;
+        }
+        out << "}}";
+    }
+    out << "\n  ],\n  \"peak_rss_kb\": " << peak_rss() << "\n}\n";
+    out.close();
+    if (!out) {
+        throw std::runtime_error{"Failed to write statistics to " + filename};
+    }
+}
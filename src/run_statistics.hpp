@@ -0,0 +1,141 @@
+/*
+ * run_statistics.hpp
+ *
+ *  Created on:  2026-10-18
+ */
+
+#ifndef SRC_RUN_STATISTICS_HPP_
+#define SRC_RUN_STATISTICS_HPP_
+
+#include <chrono>
+#include <map>
+#include <string>
+#include <vector>
+
+#include <osmium/handler.hpp>
+#include <osmium/osm/object.hpp>
+
+namespace gdalcpp {
+    class Layer;
+}
+
+using stats_clock = std::chrono::steady_clock;
+
+/**
+ * Counters of a class writing features (see OGROutputBase::write_feature).
+ */
+struct OutputStatistics {
+    struct LayerStatistics {
+        std::string name;
+        size_t features = 0;
+    };
+
+    /// time spent in OGR writing features
+    stats_clock::duration ogr_time {0};
+
+    std::map<const gdalcpp::Layer*, LayerStatistics> layers;
+};
+
+/**
+ * Statistics of one view
+ */
+struct ViewStatistics {
+    std::string name;
+
+    /// nodes and ways passed to the view
+    size_t objects = 0;
+
+    /// time spent in the handlers of the view without the time spent in OGR
+    stats_clock::duration handler_time {0};
+
+    /// time spent in OGR writing features
+    stats_clock::duration ogr_time {0};
+
+    /// number of features by layer name
+    std::map<std::string, size_t> features;
+
+    /**
+     * Add the output counters of a handler belonging to this view.
+     */
+    void add_output(const OutputStatistics& output);
+};
+
+/**
+ * Handler counting all objects it sees
+ */
+class ObjectCounter : public osmium::handler::Handler {
+    size_t m_count = 0;
+
+public:
+    void osm_object(const osmium::OSMObject&) noexcept {
+        ++m_count;
+    }
+
+    /**
+     * Does nothing. This method is required to pass the counter to
+     * osmium::relations::read_relations.
+     */
+    void prepare_for_lookup() const noexcept {
+    }
+
+    size_t count() const noexcept {
+        return m_count;
+    }
+};
+
+/**
+ * Collect statistics of a run and write them to a JSON file (--stats).
+ */
+class RunStatistics {
+    struct PassStatistics {
+        std::string name;
+        double wall_time;
+        double cpu_time;
+        size_t objects;
+        long peak_rss;
+        size_t index_size;
+        size_t index_memory;
+    };
+
+    std::vector<PassStatistics> m_passes;
+
+    std::vector<ViewStatistics> m_views;
+
+    std::string m_pass_name;
+
+    stats_clock::time_point m_pass_start;
+
+    double m_pass_cpu_start = 0.0;
+
+    /// Return the CPU time used by all threads of the process so far in seconds.
+    static double cpu_time();
+
+    /// Return the peak resident set size of the process so far in kB.
+    static long peak_rss();
+
+public:
+    /**
+     * Start time measurement of a pass.
+     */
+    void begin_pass(const std::string& name);
+
+    /**
+     * Finish time measurement of the pass started last.
+     *
+     * \param objects number of objects read during the pass
+     * \param index_size number of entries in the location index at the end of the pass
+     * \param index_memory memory used by the location index at the end of the pass
+     */
+    void end_pass(const size_t objects, const size_t index_size = 0, const size_t index_memory = 0);
+
+    void add_view(ViewStatistics&& view);
+
+    /**
+     * Write all statistics as JSON.
+     *
+     * \throws std::runtime_error if the file cannot be written
+     */
+    void write(const std::string& filename) const;
+};
+
+#endif /* SRC_RUN_STATISTICS_HPP_ */
@@ -6,6 +6,7 @@
  */
 
 #include "sac_scale_view_handler.hpp"
+#include "tag_digest.hpp"
 
 const std::array<const char*, 6> valid_sac_scales = {"hiking", "mountain_hiking",
         "demanding_mountain_hiking", "alpine_hiking", "demanding_alpine_hiking",
@@ -60,6 +61,26 @@ ViewType SacScaleViewHandler::view_type() const {
     return ViewType::sac_scale;
 }
 
+bool SacScaleViewHandler::limited_by_keys() const {
+    return true;
+}
+
+bool SacScaleViewHandler::way_has_relevant_keys(const osmium::Way& way) const {
+    return TagDigest::value(way.tags(), TagKey::sac_scale) || TagDigest::value(way.tags(), TagKey::highway);
+}
+
+key_mask_type SacScaleViewHandler::node_key_interest() const {
+    return 0;
+}
+
+key_mask_type SacScaleViewHandler::way_key_interest() const {
+    return key_bit(TagKey::sac_scale) | key_bit(TagKey::highway);
+}
+
+bool SacScaleViewHandler::supports_selection() const {
+    return true;
+}
+
 std::string SacScaleViewHandler::view_name() const {
     return "sac_scale";
 }
@@ -72,7 +93,7 @@ void SacScaleViewHandler::close() {
 
 bool SacScaleViewHandler::surface_matches_sac_scale(const osmium::Way& way,
         const char* sac_scale) {
-    const char* surface = way.get_value_by_key("surface");
+    const char* surface = TagDigest::value(way.tags(), TagKey::surface);
     if (!surface) {
         return true;
     }
@@ -87,14 +108,14 @@ bool SacScaleViewHandler::surface_matches_sac_scale(const osmium::Way& way,
 }
 
 void SacScaleViewHandler::process_sac_scale(const osmium::Way& way) {
-	const char* highway = way.get_value_by_key("highway");
-    const char* abandoned_highway = way.get_value_by_key("abandoned:highway");
-    const char* disused_highway = way.get_value_by_key("disused:highway");
+	const char* highway = TagDigest::value(way.tags(), TagKey::highway);
+    const char* abandoned_highway = TagDigest::value(way.tags(), TagKey::abandoned_highway);
+    const char* disused_highway = TagDigest::value(way.tags(), TagKey::disused_highway);
 	if (!highway && !abandoned_highway && !disused_highway) {
 	    add_to_layer(*m_sac_scale_errors, way, highway, nullptr, "error",
 	            "sac_scale without highway");
 	}
-	const char* sac_scale = way.get_value_by_key("sac_scale");
+	const char* sac_scale = TagDigest::value(way.tags(), TagKey::sac_scale);
 	bool valid_sac = value_in_array(sac_scale, valid_sac_scales);
 	bool highway_valid_for_sac = value_in_array(highway, valid_highways)
 	        || value_in_array(abandoned_highway, valid_highways) || value_in_array(disused_highway, valid_highways);
@@ -115,21 +136,22 @@ void SacScaleViewHandler::process_sac_scale(const osmium::Way& way) {
 
 void SacScaleViewHandler::process_missing_sac_scale(const osmium::Way& way,
         const char* highway) {
-    const char* footway = way.get_value_by_key("footway");
+    const char* footway = TagDigest::value(way.tags(), TagKey::footway);
     if (!strcmp(highway, "footway") && footway
             && (!strcmp(footway, "sidewalk") || !strcmp(footway, "crossing"))) {
         return;
     }
     // mtb:scale:imba is used in bike parks, those ways are dedicated for mountainbikers.
-    if (way.tags().has_key("mtb:scale:imba") || way.tags().has_tag("tunnel", "building_passage")
-            || way.tags().has_tag("tunnel", "yes") || way.tags().has_tag("indoor", "yes")
-            || way.tags().has_tag("tactile_paving", "yes")
-            || way.tags().has_tag("man_made", "pier") || way.tags().has_key("level")
-            || way.tags().has_tag("lit", "yes")) {
+    const osmium::TagList& tags = way.tags();
+    if (TagDigest::value(tags, TagKey::mtb_scale_imba) || TagDigest::has_tag(tags, TagKey::tunnel, "building_passage")
+            || TagDigest::has_tag(tags, TagKey::tunnel, "yes") || TagDigest::has_tag(tags, TagKey::indoor, "yes")
+            || TagDigest::has_tag(tags, TagKey::tactile_paving, "yes")
+            || TagDigest::has_tag(tags, TagKey::man_made, "pier") || TagDigest::value(tags, TagKey::level)
+            || TagDigest::has_tag(tags, TagKey::lit, "yes")) {
         return;
     }
-    const char* foot = way.get_value_by_key("foot");
-    const char* osm_access = way.get_value_by_key("access");
+    const char* foot = TagDigest::value(way.tags(), TagKey::foot);
+    const char* osm_access = TagDigest::value(way.tags(), TagKey::access);
     if ((foot && value_in_array(foot, no_values))
             || (!foot && osm_access && value_in_array(osm_access, no_values))) {
         // foot=no/private
@@ -138,8 +160,8 @@ void SacScaleViewHandler::process_missing_sac_scale(const osmium::Way& way,
         // At least, it becomes difficult to survey the way legally.
         return;
     }
-    const char* surface = way.get_value_by_key("surface");
-    if (way.tags().has_tag("segregated", "yes")
+    const char* surface = TagDigest::value(way.tags(), TagKey::surface);
+    if (TagDigest::has_tag(way.tags(), TagKey::segregated, "yes")
             || value_in_array(surface, good_surface_values)
             || value_in_array(surface, medium_surface_values)) {
         return;
@@ -148,19 +170,19 @@ void SacScaleViewHandler::process_missing_sac_scale(const osmium::Way& way,
             || value_in_array(surface, medium_surface_values))) {
         return;
     }
-    const char* mtb_scale_uphill = way.get_value_by_key("mtb:scale:uphill");
+    const char* mtb_scale_uphill = TagDigest::value(way.tags(), TagKey::mtb_scale_uphill);
     if (mtb_scale_uphill && (!strcmp(mtb_scale_uphill, "0") || !strcmp(mtb_scale_uphill, "1"))) {
         return;
     }
-    const char* mtb_scale = way.get_value_by_key("mtb:scale");
+    const char* mtb_scale = TagDigest::value(way.tags(), TagKey::mtb_scale);
     if (mtb_scale && (!strcmp(mtb_scale, "0"))) {
         return;
     }
     if (surface && value_in_array(surface, bad_surface_values)) {
-        add_to_layer(*m_sac_scale_warnings, way, way.get_value_by_key("highway"), nullptr,
+        add_to_layer(*m_sac_scale_warnings, way, TagDigest::value(way.tags(), TagKey::highway), nullptr,
                 "warning", "sac_scale missing");
     } else {
-        add_to_layer(*m_sac_scale_warnings, way, way.get_value_by_key("highway"), nullptr,
+        add_to_layer(*m_sac_scale_warnings, way, TagDigest::value(way.tags(), TagKey::highway), nullptr,
                 "warning", "sac_scale or surface recommended");
     }
 }
@@ -168,45 +190,48 @@ void SacScaleViewHandler::process_missing_sac_scale(const osmium::Way& way,
 void SacScaleViewHandler::add_to_layer(gdalcpp::Layer& layer, const osmium::Way& way,
         const char* highway, const char* sac_scale, const char* extra_field,
         const char* extra_value) {
+    if (selection_only()) {
+        return;
+    }
     try {
-        gdalcpp::Feature feature(layer, m_factory.create_linestring(way));
+        OutputFeature feature(layer, m_factory.create_linestring(way));
         static char idbuffer[20];
         sprintf(idbuffer, "%ld", way.id());
         feature.set_field("way_id", idbuffer);
         if (highway) {
-            feature.set_field("highway", way.get_value_by_key("highway"));
+            feature.set_field("highway", TagDigest::value(way.tags(), TagKey::highway));
         }
         if (sac_scale) {
             feature.set_field("sac_scale", sac_scale);
         }
-        const char* surface = way.get_value_by_key("surface");
+        const char* surface = TagDigest::value(way.tags(), TagKey::surface);
         if (surface) {
             feature.set_field("surface", surface);
         }
-        const char* width = way.get_value_by_key("width");
+        const char* width = TagDigest::value(way.tags(), TagKey::width);
         if (width) {
             feature.set_field("width", width);
         }
         if (extra_field && extra_value) {
             feature.set_field(extra_field, extra_value);
         }
-        std::string tags_str = tags_string<4>(way.tags(), '|', {"highway", "sac_scale",
+        const char* tags_str = tags_string<4>(way.tags(), '|', {"highway", "sac_scale",
                 "surface", "width"});
-        if (!tags_str.empty()) {
-            feature.set_field("tags", tags_str.c_str());
+        if (*tags_str) {
+            feature.set_field("tags", tags_str);
         }
-        feature.add_to_layer();
+        write_feature(feature);
     } catch (osmium::geometry_error& err) {
-        m_options.verbose_output << err.what() << "\n";
+        log_verbose(m_options.verbose_output, err.what(), "\n");
     }
 }
 
 void SacScaleViewHandler::way(const osmium::Way& way) {
-	if (way.tags().has_key("sac_scale")) {
+	if (TagDigest::value(way.tags(), TagKey::sac_scale)) {
 		process_sac_scale(way);
 		return;
 	};
-	const char* highway = way.get_value_by_key("highway");
+	const char* highway = TagDigest::value(way.tags(), TagKey::highway);
 	if (highway && (!strcmp(highway, "footway") || !strcmp(highway, "path"))) {
 	    process_missing_sac_scale(way, highway);
 	}
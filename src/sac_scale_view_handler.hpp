@@ -10,7 +10,7 @@
 
 #include "abstract_view_handler.hpp"
 
-class SacScaleViewHandler : public AbstractViewHandler {
+class SacScaleViewHandler final : public AbstractViewHandler {
     /// layer for ways with sac_scale=* set
     std::unique_ptr<gdalcpp::Layer> m_sac_scale;
     /// layer for ways with sac_scale related warnings
@@ -32,6 +32,8 @@ class SacScaleViewHandler : public AbstractViewHandler {
     void add_to_layer(gdalcpp::Layer& layer, const osmium::Way& way, const char* highway,
             const char* sac_scale, const char* extra_field = nullptr, const char* extra_value = nullptr);
 
+    bool supports_selection() const;
+
 public:
     SacScaleViewHandler(Options& options, CreateLayerFunc create_layer);
 
@@ -44,6 +46,15 @@ public:
     void area(const osmium::Area& area);
 
     ViewType view_type() const;
+
+    bool limited_by_keys() const;
+
+    bool way_has_relevant_keys(const osmium::Way& way) const;
+
+    key_mask_type node_key_interest() const;
+
+    key_mask_type way_key_interest() const;
+
     std::string view_name() const;
 
     void close();
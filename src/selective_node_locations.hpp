@@ -0,0 +1,61 @@
+/*
+ * selective_node_locations.hpp
+ *
+ *  Created on:  2026-10-18
+ */
+
+#ifndef SRC_SELECTIVE_NODE_LOCATIONS_HPP_
+#define SRC_SELECTIVE_NODE_LOCATIONS_HPP_
+
+#include <osmium/handler.hpp>
+#include <osmium/index/id_set.hpp>
+#include <osmium/osm/node.hpp>
+#include <osmium/osm/way.hpp>
+
+using id_set_type = osmium::index::IdSetDense<osmium::unsigned_object_id_type>;
+
+/**
+ * Wrapper around a location handler (usually NodeLocationsForWays) which stores the
+ * locations of selected nodes only.
+ *
+ * Locations are added to ways only if the way is selected. If no way ID set is provided,
+ * locations are added to all ways. Ways whose nodes are not all selected will get invalid
+ * locations for those nodes. Therefore the location handler should ignore errors.
+ *
+ * \tparam TLocationHandler location handler to forward the nodes and ways to
+ */
+template <typename TLocationHandler>
+class SelectiveNodeLocations : public osmium::handler::Handler {
+
+    TLocationHandler& m_location_handler;
+
+    /// nodes whose locations should be stored
+    const id_set_type& m_nodes;
+
+    /// ways which should get node locations (nullptr means all ways)
+    const id_set_type* m_ways;
+
+public:
+    SelectiveNodeLocations() = delete;
+
+    SelectiveNodeLocations(TLocationHandler& location_handler, const id_set_type& nodes,
+            const id_set_type* ways = nullptr) :
+        m_location_handler(location_handler),
+        m_nodes(nodes),
+        m_ways(ways) {
+    }
+
+    void node(const osmium::Node& node) {
+        if (m_nodes.get(node.positive_id())) {
+            m_location_handler.node(node);
+        }
+    }
+
+    void way(osmium::Way& way) {
+        if (!m_ways || m_ways->get(way.positive_id())) {
+            m_location_handler.way(way);
+        }
+    }
+};
+
+#endif /* SRC_SELECTIVE_NODE_LOCATIONS_HPP_ */
@@ -0,0 +1,81 @@
+/*
+ * shard_runner.cpp
+ *
+ *  Created on:  2026-10-18
+ */
+
+#include <iostream>
+#include <stdexcept>
+#include <stdio.h>
+#include <stdlib.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include "ogr_dataset_merge.hpp"
+#include "shard_runner.hpp"
+#include "spatial_index.hpp"
+
+int run_shards(const char* program, const std::vector<std::string>& child_options,
+        const std::string& input_filename, Options& options) {
+    const size_t count = options.spawn_shards;
+    std::vector<std::string> directories;
+    std::vector<pid_t> children;
+    bool success = true;
+    for (size_t k = 0; k < count; ++k) {
+        std::string directory = options.output_directory + "/.shard-" + std::to_string(k) + "-XXXXXX";
+        if (!mkdtemp(&directory[0])) {
+            std::cerr << "ERROR: Failed to create temporary directory in " << options.output_directory << '\n';
+            success = false;
+            break;
+        }
+        directories.push_back(directory);
+        std::vector<std::string> args;
+        args.emplace_back(program);
+        args.insert(args.end(), child_options.begin(), child_options.end());
+        args.emplace_back("--shard");
+        args.push_back(std::to_string(k) + "/" + std::to_string(count));
+        args.push_back(input_filename);
+        args.push_back(directory);
+        options.verbose_output << "Starting shard " << k << " writing to " << directory << '\n';
+        pid_t pid = fork();
+        if (pid == 0) {
+            std::vector<char*> child_argv;
+            for (std::string& a : args) {
+                child_argv.push_back(&a[0]);
+            }
+            child_argv.push_back(nullptr);
+            execvp(program, child_argv.data());
+            perror("ERROR: Failed to start shard process");
+            _exit(127);
+        } else if (pid < 0) {
+            perror("ERROR: fork failed");
+            success = false;
+            break;
+        }
+        children.push_back(pid);
+    }
+    for (size_t k = 0; k < children.size(); ++k) {
+        int status;
+        if (waitpid(children.at(k), &status, 0) < 0 || !WIFEXITED(status) || WEXITSTATUS(status) != 0) {
+            std::cerr << "ERROR: Shard " << k << " failed.\n";
+            success = false;
+        }
+    }
+    if (!success) {
+        std::cerr << "The output of the shards is kept in the subdirectories .shard-* of "
+                << options.output_directory << '\n';
+        return 1;
+    }
+    try {
+        std::vector<std::string> files = merge_shard_directories(directories, options.output_directory,
+                options.verbose_output);
+        if (options.spatial_index) {
+            build_spatial_indexes(files, options.verbose_output);
+        }
+    } catch (std::runtime_error& err) {
+        std::cerr << "ERROR: " << err.what() << '\n';
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,51 @@
+/*
+ * shard_runner.hpp
+ *
+ *  Created on:  2026-10-18
+ */
+
+#ifndef SRC_SHARD_RUNNER_HPP_
+#define SRC_SHARD_RUNNER_HPP_
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include <osmium/osm/location.hpp>
+
+#include "options.hpp"
+
+/**
+ * Get the shard (see Options::shard_index) a location belongs to. Shards are longitude bands
+ * of equal width.
+ *
+ * Invalid locations belong to the first shard. Otherwise the objects would get lost.
+ */
+inline size_t location_shard(const osmium::Location& location, const size_t shard_count) {
+    if (shard_count <= 1 || !location.valid()) {
+        return 0;
+    }
+    const size_t band = static_cast<size_t>((location.lon() + 180.0) / 360.0 * shard_count);
+    return std::min(band, shard_count - 1);
+}
+
+/**
+ * Process the input in Options::spawn_shards child processes and merge their output.
+ *
+ * Every child is a new instance of this programme called with the same options and
+ * `--shard K/N`. It writes its output into a temporary subdirectory of the output directory.
+ * After all children finished successfully, the output files are merged into the output
+ * directory.
+ *
+ * \param program name or path of this programme (argv[0])
+ * \param child_options command line options to be passed to the children (without the
+ *        positional arguments)
+ * \param input_filename path to the input file
+ * \param options programme options
+ *
+ * \returns exit code
+ */
+int run_shards(const char* program, const std::vector<std::string>& child_options,
+        const std::string& input_filename, Options& options);
+
+#endif /* SRC_SHARD_RUNNER_HPP_ */
@@ -0,0 +1,302 @@
+/*
+ * spatial_index.cpp
+ *
+ *  Created on:  2026-10-18
+ */
+
+#include "spatial_index.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <exception>
+#include <future>
+#include <limits>
+#include <memory>
+#include <stdexcept>
+#include <thread>
+#include <utility>
+
+#include <sqlite3.h>
+
+namespace {
+
+    /**
+     * Connection to an SQLite database which is closed when the object is destroyed.
+     */
+    class Database {
+        std::string m_filename;
+        sqlite3* m_database = nullptr;
+
+    public:
+        Database(const std::string& filename, const int flags) :
+            m_filename(filename) {
+            check(sqlite3_open_v2(filename.c_str(), &m_database, flags, nullptr), "opening database");
+            sqlite3_busy_timeout(m_database, 60000);
+        }
+
+        Database(const Database&) = delete;
+        Database& operator=(const Database&) = delete;
+
+        ~Database() {
+            sqlite3_close(m_database);
+        }
+
+        void check(const int result, const std::string& action) {
+            if (result != SQLITE_OK && result != SQLITE_DONE && result != SQLITE_ROW) {
+                throw std::runtime_error{action + " failed in " + m_filename + ": "
+                    + (m_database ? sqlite3_errmsg(m_database) : sqlite3_errstr(result))};
+            }
+        }
+
+        void exec(const std::string& sql) {
+            check(sqlite3_exec(m_database, sql.c_str(), nullptr, nullptr, nullptr), sql);
+        }
+
+        sqlite3_stmt* prepare(const std::string& sql) {
+            sqlite3_stmt* statement = nullptr;
+            check(sqlite3_prepare_v2(m_database, sql.c_str(), -1, &statement, nullptr), sql);
+            return statement;
+        }
+    };
+
+    /// prepared statement which is finalized when the object is destroyed
+    using statement_ptr = std::unique_ptr<sqlite3_stmt, int(*)(sqlite3_stmt*)>;
+
+    std::string quote_identifier(const std::string& identifier) {
+        std::string result {'"'};
+        for (const char c : identifier) {
+            if (c == '"') {
+                result += '"';
+            }
+            result += c;
+        }
+        result += '"';
+        return result;
+    }
+
+    std::string quote_literal(const std::string& literal) {
+        std::string result {'\''};
+        for (const char c : literal) {
+            if (c == '\'') {
+                result += '\'';
+            }
+            result += c;
+        }
+        result += '\'';
+        return result;
+    }
+
+    struct GeometryColumn {
+        std::string table;
+        std::string column;
+
+        std::string index_table() const {
+            return "idx_" + table + "_" + column;
+        }
+    };
+
+    float round_down(const double value) {
+        float result = static_cast<float>(value);
+        if (result > value) {
+            result = std::nextafter(result, -std::numeric_limits<float>::infinity());
+        }
+        return result;
+    }
+
+    float round_up(const double value) {
+        float result = static_cast<float>(value);
+        if (result < value) {
+            result = std::nextafter(result, std::numeric_limits<float>::infinity());
+        }
+        return result;
+    }
+
+    /**
+     * Read the bounding box from the header of a SpatiaLite geometry blob.
+     *
+     * \returns false if the blob is not a valid SpatiaLite geometry
+     */
+    bool read_blob_mbr(const unsigned char* blob, const int size, double* mbr) {
+        if (size < 39 || blob[0] != 0x00 || blob[38] != 0x7C || blob[1] > 1) {
+            return false;
+        }
+        const uint16_t endianness_probe = 1;
+        const bool little_endian = *reinterpret_cast<const char*>(&endianness_probe) == 1;
+        for (int i = 0; i < 4; ++i) {
+            unsigned char bytes[sizeof(double)];
+            std::memcpy(bytes, blob + 6 + i * sizeof(double), sizeof(double));
+            if ((blob[1] == 1) != little_endian) {
+                std::reverse(bytes, bytes + sizeof(double));
+            }
+            std::memcpy(mbr + i, bytes, sizeof(double));
+        }
+        return true;
+    }
+
+    /**
+     * Read the bounding boxes of all features of a table using a separate connection and
+     * sort them.
+     */
+    std::vector<SpatialIndexEntry> read_entries(const std::string& filename, const GeometryColumn& geometry_column) {
+        Database database {filename, SQLITE_OPEN_READONLY};
+        statement_ptr query {database.prepare("SELECT ROWID, " + quote_identifier(geometry_column.column)
+                + " FROM " + quote_identifier(geometry_column.table)), sqlite3_finalize};
+        std::vector<SpatialIndexEntry> entries;
+        int result;
+        while ((result = sqlite3_step(query.get())) == SQLITE_ROW) {
+            const unsigned char* blob = static_cast<const unsigned char*>(sqlite3_column_blob(query.get(), 1));
+            double mbr[4];
+            if (!blob || !read_blob_mbr(blob, sqlite3_column_bytes(query.get(), 1), mbr)) {
+                continue;
+            }
+            entries.push_back(SpatialIndexEntry{sqlite3_column_int64(query.get(), 0),
+                round_down(mbr[0]), round_up(mbr[2]), round_down(mbr[1]), round_up(mbr[3]), 0});
+        }
+        database.check(result, "reading table " + geometry_column.table);
+        sort_spatial_index_entries(entries);
+        return entries;
+    }
+
+    /**
+     * Position of a cell on the Hilbert curve filling a grid of 2^16 x 2^16 cells.
+     */
+    uint32_t hilbert_value(uint32_t x, uint32_t y) {
+        constexpr uint32_t n = 1u << 16;
+        uint32_t d = 0;
+        for (uint32_t s = n / 2; s > 0; s /= 2) {
+            const uint32_t rx = (x & s) > 0;
+            const uint32_t ry = (y & s) > 0;
+            d += s * s * ((3 * rx) ^ ry);
+            if (ry == 0) {
+                if (rx == 1) {
+                    x = n - 1 - x;
+                    y = n - 1 - y;
+                }
+                std::swap(x, y);
+            }
+        }
+        return d;
+    }
+
+    void insert_entries(Database& database, const GeometryColumn& geometry_column,
+            const std::vector<SpatialIndexEntry>& entries) {
+        const std::string index_table = quote_identifier(geometry_column.index_table());
+        const std::string table = quote_identifier(geometry_column.table);
+        const std::string column = quote_identifier(geometry_column.column);
+        database.exec("CREATE VIRTUAL TABLE " + index_table + " USING rtree(pkid, xmin, xmax, ymin, ymax)");
+        statement_ptr insert {database.prepare("INSERT INTO " + index_table
+                + " (pkid, xmin, xmax, ymin, ymax) VALUES (?, ?, ?, ?, ?)"), sqlite3_finalize};
+        for (const SpatialIndexEntry& entry : entries) {
+            sqlite3_bind_int64(insert.get(), 1, entry.id);
+            sqlite3_bind_double(insert.get(), 2, entry.min_x);
+            sqlite3_bind_double(insert.get(), 3, entry.max_x);
+            sqlite3_bind_double(insert.get(), 4, entry.min_y);
+            sqlite3_bind_double(insert.get(), 5, entry.max_y);
+            const int result = sqlite3_step(insert.get());
+            sqlite3_reset(insert.get());
+            database.check(result, "inserting into " + geometry_column.index_table());
+        }
+        // same triggers as created by CreateSpatialIndex() of SpatiaLite
+        const std::string trigger_suffix = geometry_column.table + "_" + geometry_column.column;
+        const std::string index_literal = quote_literal(geometry_column.index_table());
+        database.exec("CREATE TRIGGER " + quote_identifier("gii_" + trigger_suffix) + " AFTER INSERT ON " + table
+                + "\nFOR EACH ROW BEGIN\nDELETE FROM " + index_table + " WHERE pkid=NEW.ROWID;\n"
+                + "SELECT RTreeAlign(" + index_literal + ", NEW.ROWID, NEW." + column + ");\nEND");
+        database.exec("CREATE TRIGGER " + quote_identifier("giu_" + trigger_suffix) + " AFTER UPDATE OF "
+                + column + " ON " + table
+                + "\nFOR EACH ROW BEGIN\nDELETE FROM " + index_table + " WHERE pkid=NEW.ROWID;\n"
+                + "SELECT RTreeAlign(" + index_literal + ", NEW.ROWID, NEW." + column + ");\nEND");
+        database.exec("CREATE TRIGGER " + quote_identifier("gid_" + trigger_suffix) + " AFTER DELETE ON " + table
+                + "\nFOR EACH ROW BEGIN\nDELETE FROM " + index_table + " WHERE pkid=OLD.ROWID;\nEND");
+        database.exec("UPDATE geometry_columns SET spatial_index_enabled = 1 WHERE f_table_name = "
+                + quote_literal(geometry_column.table) + " AND f_geometry_column = "
+                + quote_literal(geometry_column.column));
+    }
+
+} // namespace
+
+void sort_spatial_index_entries(std::vector<SpatialIndexEntry>& entries) {
+    if (entries.empty()) {
+        return;
+    }
+    // extent of the centers of the bounding boxes (twice their coordinates)
+    double min_x = std::numeric_limits<double>::max();
+    double min_y = std::numeric_limits<double>::max();
+    double max_x = std::numeric_limits<double>::lowest();
+    double max_y = std::numeric_limits<double>::lowest();
+    for (const SpatialIndexEntry& entry : entries) {
+        const double x = static_cast<double>(entry.min_x) + entry.max_x;
+        const double y = static_cast<double>(entry.min_y) + entry.max_y;
+        min_x = std::min(min_x, x);
+        min_y = std::min(min_y, y);
+        max_x = std::max(max_x, x);
+        max_y = std::max(max_y, y);
+    }
+    const double scale_x = (max_x > min_x) ? 65535.0 / (max_x - min_x) : 0.0;
+    const double scale_y = (max_y > min_y) ? 65535.0 / (max_y - min_y) : 0.0;
+    for (SpatialIndexEntry& entry : entries) {
+        const double x = static_cast<double>(entry.min_x) + entry.max_x;
+        const double y = static_cast<double>(entry.min_y) + entry.max_y;
+        entry.hilbert = hilbert_value(static_cast<uint32_t>((x - min_x) * scale_x),
+                static_cast<uint32_t>((y - min_y) * scale_y));
+    }
+    std::sort(entries.begin(), entries.end(), [](const SpatialIndexEntry& a, const SpatialIndexEntry& b) {
+        return a.hilbert < b.hilbert;
+    });
+}
+
+size_t build_spatial_index(const std::string& filename) {
+    Database database {filename, SQLITE_OPEN_READWRITE};
+    database.exec("PRAGMA journal_mode=OFF");
+    database.exec("PRAGMA synchronous=OFF");
+    std::vector<GeometryColumn> geometry_columns;
+    {
+        statement_ptr query {database.prepare("SELECT f_table_name, f_geometry_column FROM geometry_columns"
+                " WHERE spatial_index_enabled = 0"), sqlite3_finalize};
+        int result;
+        while ((result = sqlite3_step(query.get())) == SQLITE_ROW) {
+            geometry_columns.push_back(GeometryColumn{
+                reinterpret_cast<const char*>(sqlite3_column_text(query.get(), 0)),
+                reinterpret_cast<const char*>(sqlite3_column_text(query.get(), 1))});
+        }
+        database.check(result, "reading geometry_columns");
+    }
+
+    // Read and sort the bounding boxes of all tables in parallel. Only one connection can
+    // write at a time, therefore the indexes are filled one after another.
+    std::vector<std::future<std::vector<SpatialIndexEntry>>> entries;
+    for (const GeometryColumn& geometry_column : geometry_columns) {
+        entries.push_back(std::async(std::launch::async, read_entries, filename, geometry_column));
+    }
+    database.exec("BEGIN");
+    for (size_t i = 0; i < geometry_columns.size(); ++i) {
+        insert_entries(database, geometry_columns.at(i), entries.at(i).get());
+    }
+    database.exec("COMMIT");
+    return geometry_columns.size();
+}
+
+void build_spatial_indexes(const std::vector<std::string>& filenames, osmium::util::VerboseOutput& verbose_output) {
+    verbose_output << "Building spatial indexes of " << filenames.size() << " datasets ...\n";
+    std::vector<std::future<size_t>> results;
+    for (const std::string& filename : filenames) {
+        results.push_back(std::async(std::launch::async, build_spatial_index, filename));
+    }
+    // Wait for all threads before the first error is thrown.
+    size_t count = 0;
+    std::exception_ptr error;
+    for (auto& result : results) {
+        try {
+            count += result.get();
+        } catch (...) {
+            if (!error) {
+                error = std::current_exception();
+            }
+        }
+    }
+    if (error) {
+        std::rethrow_exception(error);
+    }
+    verbose_output << "Built " << count << " spatial indexes\n";
+}
@@ -0,0 +1,59 @@
+/*
+ * spatial_index.hpp
+ *
+ *  Created on:  2026-10-18
+ */
+
+#ifndef SRC_SPATIAL_INDEX_HPP_
+#define SRC_SPATIAL_INDEX_HPP_
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include <osmium/util/verbose_output.hpp>
+
+/**
+ * Bounding box of a feature as stored in the R*Tree.
+ */
+struct SpatialIndexEntry {
+    int64_t id;
+    /// Coordinates are rounded outwards to single precision like SQLite's R*Tree does.
+    float min_x;
+    float max_x;
+    float min_y;
+    float max_y;
+    /// position of the center on the Hilbert curve over the extent of the layer
+    uint32_t hilbert;
+};
+
+/**
+ * Sort the entries by the Hilbert value of the centers of their bounding boxes.
+ *
+ * Entries which are close to each other end up in the same R*Tree nodes if they are
+ * inserted in this order.
+ */
+void sort_spatial_index_entries(std::vector<SpatialIndexEntry>& entries);
+
+/**
+ * Build SpatiaLite spatial indexes for all geometry columns of a SpatiaLite database which
+ * do not have one yet.
+ *
+ * The bounding boxes are read from the geometry blobs, sorted along a Hilbert curve and
+ * inserted into the R*Tree in a single transaction. The tables are read in parallel.
+ * The triggers which keep the index up to date are the same ones SpatiaLite creates.
+ *
+ * \returns number of indexes built
+ *
+ * \throws std::runtime_error
+ */
+size_t build_spatial_index(const std::string& filename);
+
+/**
+ * Build the spatial indexes of multiple databases in parallel.
+ *
+ * \throws std::runtime_error (the first error)
+ */
+void build_spatial_indexes(const std::vector<std::string>& filenames, osmium::util::VerboseOutput& verbose_output);
+
+#endif /* SRC_SPATIAL_INDEX_HPP_ */
@@ -0,0 +1,410 @@
+/*
+ * spatialite_writer.cpp
+ *
+ *  Created on:  2026-10-18
+ */
+
+#include "spatialite_writer.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+
+namespace {
+
+    /// SpatiaLite geometry classes
+    enum class BlobClass : int32_t {
+        point = 1,
+        linestring = 2,
+        polygon = 3,
+        multipoint = 4,
+        multilinestring = 5,
+        multipolygon = 6
+    };
+
+    /**
+     * Append the body of a geometry to a SpatiaLite blob (uncompressed, native byte order)
+     * and track its bounding box.
+     */
+    class BlobBuilder {
+        std::string& m_blob;
+
+        double m_min_x = std::numeric_limits<double>::max();
+        double m_min_y = std::numeric_limits<double>::max();
+        double m_max_x = std::numeric_limits<double>::lowest();
+        double m_max_y = std::numeric_limits<double>::lowest();
+
+        template <typename T>
+        void append(const T value) {
+            m_blob.append(reinterpret_cast<const char*>(&value), sizeof(T));
+        }
+
+        void add_point(const double x, const double y) {
+            append(x);
+            append(y);
+            m_min_x = std::min(m_min_x, x);
+            m_min_y = std::min(m_min_y, y);
+            m_max_x = std::max(m_max_x, x);
+            m_max_y = std::max(m_max_y, y);
+        }
+
+        void add_linestring(const OGRLineString& linestring) {
+            const int count = linestring.getNumPoints();
+            append(static_cast<int32_t>(count));
+            for (int i = 0; i < count; ++i) {
+                add_point(linestring.getX(i), linestring.getY(i));
+            }
+        }
+
+        void add_polygon(const OGRPolygon& polygon) {
+            const OGRLinearRing* outer = polygon.getExteriorRing();
+            if (!outer) {
+                append(static_cast<int32_t>(0));
+                return;
+            }
+            const int inner_count = polygon.getNumInteriorRings();
+            append(static_cast<int32_t>(inner_count + 1));
+            add_linestring(*outer);
+            for (int i = 0; i < inner_count; ++i) {
+                add_linestring(*(polygon.getInteriorRing(i)));
+            }
+        }
+
+        template <typename TMember>
+        void add_collection(const OGRGeometryCollection& collection, const BlobClass member_class) {
+            const int count = collection.getNumGeometries();
+            append(static_cast<int32_t>(count));
+            for (int i = 0; i < count; ++i) {
+                // entity marker
+                m_blob += static_cast<char>(0x69);
+                append(static_cast<int32_t>(member_class));
+                add(static_cast<const TMember&>(*(collection.getGeometryRef(i))));
+            }
+        }
+
+        void add(const OGRPoint& point) {
+            add_point(point.getX(), point.getY());
+        }
+
+        void add(const OGRLineString& linestring) {
+            add_linestring(linestring);
+        }
+
+        void add(const OGRPolygon& polygon) {
+            add_polygon(polygon);
+        }
+
+    public:
+        explicit BlobBuilder(std::string& blob) :
+            m_blob(blob) {
+        }
+
+        /**
+         * Append class type and body of the geometry.
+         */
+        void add_geometry(const OGRGeometry& geometry) {
+            switch (wkbFlatten(geometry.getGeometryType())) {
+            case wkbPoint:
+                append(static_cast<int32_t>(BlobClass::point));
+                add(static_cast<const OGRPoint&>(geometry));
+                break;
+            case wkbLineString:
+                append(static_cast<int32_t>(BlobClass::linestring));
+                add(static_cast<const OGRLineString&>(geometry));
+                break;
+            case wkbPolygon:
+                append(static_cast<int32_t>(BlobClass::polygon));
+                add(static_cast<const OGRPolygon&>(geometry));
+                break;
+            case wkbMultiPoint:
+                append(static_cast<int32_t>(BlobClass::multipoint));
+                add_collection<OGRPoint>(static_cast<const OGRGeometryCollection&>(geometry), BlobClass::point);
+                break;
+            case wkbMultiLineString:
+                append(static_cast<int32_t>(BlobClass::multilinestring));
+                add_collection<OGRLineString>(static_cast<const OGRGeometryCollection&>(geometry),
+                        BlobClass::linestring);
+                break;
+            case wkbMultiPolygon:
+                append(static_cast<int32_t>(BlobClass::multipolygon));
+                add_collection<OGRPolygon>(static_cast<const OGRGeometryCollection&>(geometry),
+                        BlobClass::polygon);
+                break;
+            default:
+                throw std::runtime_error{std::string{"geometry type "} + geometry.getGeometryName()
+                    + " is not supported by the SpatiaLite writer"};
+            }
+        }
+
+        /**
+         * Write the bounding box to its position in the header.
+         */
+        void write_mbr(const size_t offset) {
+            if (m_min_x > m_max_x) {
+                // empty geometry
+                m_min_x = m_min_y = m_max_x = m_max_y = 0.0;
+            }
+            const double mbr[4] = {m_min_x, m_min_y, m_max_x, m_max_y};
+            std::memcpy(&m_blob[offset], mbr, sizeof(mbr));
+        }
+    };
+
+    std::string quote_identifier(const char* identifier) {
+        std::string result {'"'};
+        for (const char* c = identifier; *c; ++c) {
+            if (*c == '"') {
+                result += '"';
+            }
+            result += *c;
+        }
+        result += '"';
+        return result;
+    }
+
+} // namespace
+
+SpatialiteWriter::SpatialiteWriter(gdalcpp::Dataset& dataset, const std::string& filename,
+        const size_t transaction_size) :
+    m_dataset(dataset),
+    m_filename(filename),
+    m_layers(),
+    m_statements(),
+    m_transaction_size(transaction_size),
+    m_blob() {
+}
+
+SpatialiteWriter::~SpatialiteWriter() {
+    close();
+}
+
+void SpatialiteWriter::check(const int result, const char* action) {
+    if (result != SQLITE_OK && result != SQLITE_DONE && result != SQLITE_ROW) {
+        throw std::runtime_error{std::string{action} + " failed in " + m_filename + ": "
+            + (m_database ? sqlite3_errmsg(m_database) : sqlite3_errstr(result))};
+    }
+}
+
+void SpatialiteWriter::exec(const char* sql) {
+    check(sqlite3_exec(m_database, sql, nullptr, nullptr, nullptr), sql);
+}
+
+void SpatialiteWriter::add_layer(gdalcpp::Layer& layer) {
+    m_layers.push_back(&layer);
+}
+
+void SpatialiteWriter::prepare_layer(gdalcpp::Layer& layer) {
+    const char* table = layer.get().GetName();
+    const char* geometry_column = layer.get().GetGeometryColumn();
+
+    // Look up the SRID and make sure that there are no triggers which require SpatiaLite
+    // functions (e.g. if the layer was created with a spatial index).
+    sqlite3_stmt* query = nullptr;
+    check(sqlite3_prepare_v2(m_database, "SELECT srid, f_table_name, f_geometry_column FROM geometry_columns"
+            " WHERE lower(f_table_name) = lower(?1) AND lower(f_geometry_column) = lower(?2)",
+            -1, &query, nullptr), "querying geometry_columns");
+    sqlite3_bind_text(query, 1, table, -1, SQLITE_STATIC);
+    sqlite3_bind_text(query, 2, geometry_column, -1, SQLITE_STATIC);
+    const int found = sqlite3_step(query);
+    LayerStatement& statement = m_statements[&layer];
+    if (found == SQLITE_ROW) {
+        statement.srid = sqlite3_column_int(query, 0);
+        statement.table = reinterpret_cast<const char*>(sqlite3_column_text(query, 1));
+        statement.geometry_column = reinterpret_cast<const char*>(sqlite3_column_text(query, 2));
+    }
+    sqlite3_finalize(query);
+    if (found != SQLITE_ROW) {
+        throw std::runtime_error{std::string{"table "} + table + " has no SpatiaLite geometry column in "
+            + m_filename};
+    }
+    check(sqlite3_prepare_v2(m_database, "SELECT count(*) FROM sqlite_master"
+            " WHERE type = 'trigger' AND lower(tbl_name) = lower(?1)", -1, &query, nullptr),
+            "querying sqlite_master");
+    sqlite3_bind_text(query, 1, table, -1, SQLITE_STATIC);
+    const int triggers = (sqlite3_step(query) == SQLITE_ROW) ? sqlite3_column_int(query, 0) : 0;
+    sqlite3_finalize(query);
+    if (triggers > 0) {
+        throw std::runtime_error{std::string{"table "} + table + " has triggers which cannot be run"
+            " without SpatiaLite"};
+    }
+
+    // The geometry is the first parameter, field i of the layer definition is parameter i + 2.
+    std::string sql = "INSERT INTO ";
+    sql += quote_identifier(table);
+    sql += " (";
+    sql += quote_identifier(geometry_column);
+    std::string values = "?";
+    OGRFeatureDefn* definition = layer.get().GetLayerDefn();
+    for (int i = 0; i < definition->GetFieldCount(); ++i) {
+        sql += ", ";
+        sql += quote_identifier(definition->GetFieldDefn(i)->GetNameRef());
+        values += ", ?";
+    }
+    sql += ") VALUES (";
+    sql += values;
+    sql += ")";
+    check(sqlite3_prepare_v2(m_database, sql.c_str(), -1, &(statement.statement), nullptr),
+            "preparing INSERT statement");
+}
+
+void SpatialiteWriter::open() {
+    // OGR creates the tables lazily. The second connection must not wait for a transaction
+    // of the OGR connection.
+    m_dataset.get().FlushCache();
+    m_dataset.disable_auto_transactions();
+    check(sqlite3_open_v2(m_filename.c_str(), &m_database, SQLITE_OPEN_READWRITE, nullptr),
+            "opening database");
+    sqlite3_busy_timeout(m_database, 60000);
+    exec("PRAGMA journal_mode=OFF");
+    exec("PRAGMA synchronous=OFF");
+    exec("PRAGMA temp_store=MEMORY");
+    for (gdalcpp::Layer* layer : m_layers) {
+        prepare_layer(*layer);
+    }
+    exec("BEGIN");
+}
+
+void SpatialiteWriter::write(OutputFeature&& feature) {
+    auto it = m_statements.find(&(feature.layer()));
+    if (it == m_statements.end() || !it->second.statement) {
+        throw std::runtime_error{std::string{"layer "} + feature.layer().name() + " was not prepared for writing"};
+    }
+    LayerStatement& layer_statement = it->second;
+    sqlite3_stmt* statement = layer_statement.statement;
+    if (feature.geometry()) {
+        build_blob(*(feature.geometry()), layer_statement.srid, m_blob);
+        sqlite3_bind_blob(statement, 1, m_blob.data(), static_cast<int>(m_blob.size()), SQLITE_STATIC);
+        if (!feature.geometry()->IsEmpty()) {
+            // bounding box in the header of the blob
+            double mbr[4];
+            std::memcpy(mbr, m_blob.data() + 6, sizeof(mbr));
+            layer_statement.min_x = std::min(layer_statement.min_x, mbr[0]);
+            layer_statement.min_y = std::min(layer_statement.min_y, mbr[1]);
+            layer_statement.max_x = std::max(layer_statement.max_x, mbr[2]);
+            layer_statement.max_y = std::max(layer_statement.max_y, mbr[3]);
+        }
+    }
+    for (const OutputFeature::Field& field : feature.fields()) {
+        const int parameter = field.index + 2;
+        switch (field.type) {
+        case OutputFeature::Field::Type::integer:
+            sqlite3_bind_int(statement, parameter, static_cast<int>(field.integer));
+            break;
+        case OutputFeature::Field::Type::integer64:
+            sqlite3_bind_int64(statement, parameter, field.integer);
+            break;
+        case OutputFeature::Field::Type::string:
+            sqlite3_bind_text(statement, parameter, feature.string_value(field),
+                    static_cast<int>(field.length), SQLITE_STATIC);
+            break;
+        }
+    }
+    const int result = sqlite3_step(statement);
+    sqlite3_reset(statement);
+    // Fields not set by the next feature have to be NULL.
+    sqlite3_clear_bindings(statement);
+    check(result, "inserting a feature");
+    ++layer_statement.rows;
+    if (++m_inserts >= m_transaction_size) {
+        exec("COMMIT");
+        exec("BEGIN");
+        m_inserts = 0;
+    }
+}
+
+void SpatialiteWriter::close() {
+    // The statistics of the layers are kept for write_statistics().
+    for (auto& s : m_statements) {
+        sqlite3_finalize(s.second.statement);
+        s.second.statement = nullptr;
+    }
+    if (m_database) {
+        sqlite3_close(m_database);
+        m_database = nullptr;
+    }
+}
+
+void SpatialiteWriter::finish() {
+    if (m_database) {
+        exec("COMMIT");
+    }
+    close();
+}
+
+bool SpatialiteWriter::has_table(const char* table) {
+    sqlite3_stmt* query = nullptr;
+    check(sqlite3_prepare_v2(m_database, "SELECT count(*) FROM sqlite_master WHERE type = 'table' AND name = ?1",
+            -1, &query, nullptr), "querying sqlite_master");
+    sqlite3_bind_text(query, 1, table, -1, SQLITE_STATIC);
+    const bool found = (sqlite3_step(query) == SQLITE_ROW) && sqlite3_column_int(query, 0) > 0;
+    sqlite3_finalize(query);
+    return found;
+}
+
+void SpatialiteWriter::write_statistics() {
+    if (m_statements.empty()) {
+        return;
+    }
+    check(sqlite3_open_v2(m_filename.c_str(), &m_database, SQLITE_OPEN_READWRITE, nullptr),
+            "opening database");
+    sqlite3_busy_timeout(m_database, 60000);
+    // SpatiaLite 4 and newer use geometry_columns_statistics, older versions layer_statistics.
+    const char* sql = nullptr;
+    if (has_table("geometry_columns_statistics")) {
+        sql = "INSERT OR REPLACE INTO geometry_columns_statistics (f_table_name, f_geometry_column,"
+            " last_verified, row_count, extent_min_x, extent_min_y, extent_max_x, extent_max_y)"
+            " VALUES (?1, ?2, strftime('%Y-%m-%dT%H:%M:%fZ', 'now'), ?3, ?4, ?5, ?6, ?7)";
+    } else if (has_table("layer_statistics")) {
+        sql = "INSERT OR REPLACE INTO layer_statistics (raster_layer, table_name, geometry_column,"
+            " row_count, extent_min_x, extent_min_y, extent_max_x, extent_max_y)"
+            " VALUES (0, ?1, ?2, ?3, ?4, ?5, ?6, ?7)";
+    }
+    if (sql) {
+        sqlite3_stmt* update = nullptr;
+        check(sqlite3_prepare_v2(m_database, sql, -1, &update, nullptr), "preparing statistics update");
+        for (const auto& s : m_statements) {
+            const LayerStatement& layer = s.second;
+            if (layer.table.empty()) {
+                continue;
+            }
+            sqlite3_bind_text(update, 1, layer.table.c_str(), -1, SQLITE_STATIC);
+            sqlite3_bind_text(update, 2, layer.geometry_column.c_str(), -1, SQLITE_STATIC);
+            sqlite3_bind_int64(update, 3, static_cast<sqlite3_int64>(layer.rows));
+            // The extent stays NULL if there are no geometries.
+            if (layer.min_x <= layer.max_x) {
+                sqlite3_bind_double(update, 4, layer.min_x);
+                sqlite3_bind_double(update, 5, layer.min_y);
+                sqlite3_bind_double(update, 6, layer.max_x);
+                sqlite3_bind_double(update, 7, layer.max_y);
+            }
+            const int result = sqlite3_step(update);
+            sqlite3_reset(update);
+            sqlite3_clear_bindings(update);
+            if (result != SQLITE_DONE) {
+                sqlite3_finalize(update);
+                check(result, "updating the layer statistics");
+            }
+        }
+        sqlite3_finalize(update);
+    }
+    close();
+}
+
+/*static*/ void SpatialiteWriter::build_blob(const OGRGeometry& geometry, const int srid, std::string& blob) {
+    const uint16_t endianness_probe = 1;
+    const bool little_endian = *reinterpret_cast<const char*>(&endianness_probe) == 1;
+    blob.clear();
+    blob += static_cast<char>(0x00);
+    blob += static_cast<char>(little_endian ? 0x01 : 0x00);
+    const int32_t srid32 = srid;
+    blob.append(reinterpret_cast<const char*>(&srid32), sizeof(srid32));
+    // placeholder for the bounding box
+    const size_t mbr_offset = blob.size();
+    blob.append(4 * sizeof(double), '\0');
+    blob += static_cast<char>(0x7C);
+    BlobBuilder builder {blob};
+    builder.add_geometry(geometry);
+    builder.write_mbr(mbr_offset);
+    blob += static_cast<char>(0xFE);
+}
@@ -0,0 +1,142 @@
+/*
+ * spatialite_writer.hpp
+ *
+ *  Created on:  2026-10-18
+ */
+
+#ifndef SRC_SPATIALITE_WRITER_HPP_
+#define SRC_SPATIALITE_WRITER_HPP_
+
+#include <limits>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <sqlite3.h>
+
+#include "feature_writer.hpp"
+
+/**
+ * Write features to the layers of a SpatiaLite dataset created by OGR using prepared INSERT
+ * statements and SpatiaLite geometry blobs built without OGR.
+ *
+ * OGR still creates the dataset and its layers. Therefore the schema is the same as the one of
+ * the OGR output. After all layers have been created and all fields have been added, open()
+ * makes OGR create the tables and opens a second connection to the database file. The OGR
+ * connection must not write anything afterwards, i.e. it must not use exclusive locking mode
+ * and all features of the dataset have to be written by this class.
+ */
+class SpatialiteWriter : public FeatureWriter {
+    struct LayerStatement {
+        sqlite3_stmt* statement = nullptr;
+        /// SRID of the geometry column
+        int srid = 0;
+        /// table and geometry column as registered in geometry_columns
+        std::string table;
+        std::string geometry_column;
+        /// number of rows and extent of the geometries inserted
+        size_t rows = 0;
+        double min_x = std::numeric_limits<double>::max();
+        double min_y = std::numeric_limits<double>::max();
+        double max_x = std::numeric_limits<double>::lowest();
+        double max_y = std::numeric_limits<double>::lowest();
+    };
+
+    gdalcpp::Dataset& m_dataset;
+
+    std::string m_filename;
+
+    std::vector<gdalcpp::Layer*> m_layers;
+
+    std::unordered_map<const gdalcpp::Layer*, LayerStatement> m_statements;
+
+    sqlite3* m_database = nullptr;
+
+    /// maximum number of inserts per transaction
+    size_t m_transaction_size;
+
+    size_t m_inserts = 0;
+
+    /// buffer for the geometry blob, reused for all features
+    std::string m_blob;
+
+    void exec(const char* sql);
+
+    void check(const int result, const char* action);
+
+    void prepare_layer(gdalcpp::Layer& layer);
+
+    bool has_table(const char* table);
+
+    void close();
+
+public:
+    /**
+     * \param dataset OGR dataset with SpatiaLite metadata
+     * \param filename name of the database file of the dataset
+     * \param transaction_size maximum number of inserts per transaction
+     */
+    SpatialiteWriter(gdalcpp::Dataset& dataset, const std::string& filename,
+            const size_t transaction_size = 10000);
+
+    SpatialiteWriter(const SpatialiteWriter&) = delete;
+    SpatialiteWriter& operator=(const SpatialiteWriter&) = delete;
+
+    ~SpatialiteWriter();
+
+    /**
+     * Register a layer of the dataset. All layers have to be registered before open() is
+     * called.
+     */
+    void add_layer(gdalcpp::Layer& layer);
+
+    /**
+     * Create the tables of all layers and prepare the INSERT statements.
+     *
+     * This method must be called after all fields of all layers have been added.
+     *
+     * \throws std::runtime_error
+     */
+    void open();
+
+    /**
+     * Insert a feature into its table.
+     *
+     * \throws std::runtime_error
+     */
+    void write(OutputFeature&& feature) override;
+
+    /**
+     * Commit the last transaction and close the database connection.
+     *
+     * \throws std::runtime_error
+     */
+    void finish() override;
+
+    /**
+     * Write the number of rows and the extent of all layers to the statistics tables of
+     * SpatiaLite (geometry_columns_statistics or the legacy layer_statistics).
+     *
+     * OGR never sees the rows inserted by this class. When it closes the dataset, it writes
+     * its cached statistics (no rows, empty extent). Therefore this method has to be called
+     * after the OGR dataset has been closed.
+     *
+     * \throws std::runtime_error
+     */
+    void write_statistics();
+
+    /**
+     * Build the SpatiaLite blob of a geometry.
+     *
+     * Supported are points, linestrings, polygons and their multi variants (2D only).
+     *
+     * \param geometry geometry
+     * \param srid SRID of the geometry column
+     * \param blob buffer where the blob is written to (it is cleared first)
+     *
+     * \throws std::runtime_error if the geometry type is not supported
+     */
+    static void build_blob(const OGRGeometry& geometry, const int srid, std::string& blob);
+};
+
+#endif /* SRC_SPATIALITE_WRITER_HPP_ */
@@ -0,0 +1,46 @@
+/*
+ * tag_digest.cpp
+ *
+ *  Created on:  2026-10-18
+ */
+
+#include "tag_digest.hpp"
+
+static_assert(TagDigest::collision_free(), "keys of TagKey collide, choose another tag_digest::hash_seed");
+
+thread_local const TagDigest* TagDigest::m_current = nullptr;
+
+void TagDigest::update(const osmium::TagList& tags) noexcept {
+    m_tags = &tags;
+    // Most nodes have no tags. There is nothing to reset after them.
+    if (m_key_mask != every_object) {
+        m_values.fill(nullptr);
+        m_key_mask = every_object;
+    }
+    for (const osmium::Tag& tag : tags) {
+        const TagKey id = key_id(tag.key());
+        // Like osmium::TagList::get_value_by_key, the first occurrence of a key wins.
+        if (id != TagKey::count && !m_values[static_cast<size_t>(id)]) {
+            m_values[static_cast<size_t>(id)] = tag.value();
+            m_key_mask |= key_bit(id);
+        }
+    }
+}
+
+void TagDigest::store(std::vector<const char*>& values) const {
+    for (key_mask_type keys = m_key_mask & ~every_object; keys; keys &= keys - 1) {
+        values.push_back(m_values[__builtin_ctzll(keys)]);
+    }
+}
+
+void TagDigest::restore(const osmium::TagList& tags, const key_mask_type key_mask,
+        const char* const* values) noexcept {
+    m_tags = &tags;
+    if (m_key_mask != every_object) {
+        m_values.fill(nullptr);
+    }
+    m_key_mask = key_mask | every_object;
+    for (key_mask_type keys = key_mask & ~every_object; keys; keys &= keys - 1) {
+        m_values[__builtin_ctzll(keys)] = *values++;
+    }
+}
@@ -0,0 +1,291 @@
+/*
+ * tag_digest.hpp
+ *
+ *  Created on:  2026-10-18
+ */
+
+#ifndef SRC_TAG_DIGEST_HPP_
+#define SRC_TAG_DIGEST_HPP_
+
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+#include <osmium/osm/tag.hpp>
+
+/**
+ * Keys which are looked up by the checks of several views. The order has to match
+ * tag_digest_keys.
+ */
+enum class TagKey : uint8_t {
+    access,
+    abandoned,
+    abandoned_highway,
+    amenity,
+    construction,
+    construction_highway,
+    cycleway,
+    cycleway_left,
+    cycleway_right,
+    dismantled,
+    disused,
+    disused_highway,
+    foot,
+    footway,
+    highway,
+    indoor,
+    junction,
+    lanes,
+    lanes_backward,
+    lanes_both_ways,
+    lanes_forward,
+    level,
+    lit,
+    man_made,
+    maxheight,
+    maxlength,
+    maxspeed,
+    maxweight,
+    mtb_scale,
+    mtb_scale_imba,
+    mtb_scale_uphill,
+    name,
+    noname,
+    oneway,
+    place,
+    proposed,
+    proposed_highway,
+    railway,
+    razed,
+    ref,
+    sac_scale,
+    segregated,
+    shop,
+    surface,
+    tactile_paving,
+    tiger_reviewed,
+    tunnel,
+    turn_lanes,
+    turn_lanes_backward,
+    turn_lanes_both_ways,
+    turn_lanes_forward,
+    width,
+    count
+};
+
+constexpr size_t tag_digest_key_count = static_cast<size_t>(TagKey::count);
+
+constexpr std::array<const char*, tag_digest_key_count> tag_digest_keys {{
+    "access", "abandoned", "abandoned:highway", "amenity", "construction", "construction:highway",
+    "cycleway", "cycleway:left", "cycleway:right", "dismantled", "disused", "disused:highway", "foot",
+    "footway", "highway", "indoor", "junction", "lanes", "lanes:backward", "lanes:both_ways",
+    "lanes:forward", "level", "lit", "man_made", "maxheight", "maxlength", "maxspeed", "maxweight",
+    "mtb:scale", "mtb:scale:imba", "mtb:scale:uphill", "name", "noname", "oneway", "place",
+    "proposed", "proposed:highway", "railway", "razed", "ref", "sac_scale", "segregated", "shop",
+    "surface", "tactile_paving", "tiger:reviewed", "tunnel", "turn:lanes", "turn:lanes:backward",
+    "turn:lanes:both_ways", "turn:lanes:forward", "width"
+}};
+
+namespace tag_digest {
+
+    /// size of the hash table (power of 2)
+    constexpr size_t table_size = 128;
+
+    /// seed of the hash function, chosen such that no keys of TagKey collide
+    constexpr uint32_t hash_seed = 96974;
+
+    constexpr uint8_t empty_slot = 0xff;
+
+    /**
+     * FNV-1a hash reduced to table_size slots.
+     */
+    constexpr size_t hash(const char* key) noexcept {
+        uint32_t value = 2166136261u ^ hash_seed;
+        for (; *key; ++key) {
+            value ^= static_cast<uint8_t>(*key);
+            value *= 16777619u;
+        }
+        return value >> 25;
+    }
+
+    /**
+     * Build the table mapping hash values to TagKey.
+     */
+    constexpr std::array<uint8_t, table_size> build_table() noexcept {
+        std::array<uint8_t, table_size> table {};
+        for (size_t i = 0; i < table_size; ++i) {
+            table[i] = empty_slot;
+        }
+        for (size_t i = 0; i < tag_digest_key_count; ++i) {
+            table[hash(tag_digest_keys[i])] = static_cast<uint8_t>(i);
+        }
+        return table;
+    }
+
+} // namespace tag_digest
+
+/**
+ * Set of keys of TagKey, one bit per key.
+ */
+using key_mask_type = uint64_t;
+
+static_assert(tag_digest_key_count < 63, "TagKey has too many keys for key_mask_type");
+
+constexpr key_mask_type key_bit(const TagKey key) noexcept {
+    return key_mask_type{1} << static_cast<unsigned>(key);
+}
+
+/**
+ * Bit set in the key mask of every object. A handler which has to see all objects (e.g.
+ * untagged ones or ones with keys not listed in TagKey) declares an interest in this bit.
+ */
+constexpr key_mask_type every_object = key_mask_type{1} << 63;
+
+/**
+ * Values of the keys listed in TagKey of one tag list.
+ *
+ * The tags of an object are walked once. Each key is mapped to its TagKey by a perfect hash
+ * (one hash and one string comparison per tag). Afterwards the value of every key in TagKey
+ * is available in O(1) instead of a linear scan of the tag list per lookup.
+ *
+ * HandlerCollection builds the digest of each node and way once and makes it available
+ * to all handlers using a Scope. The checks use TagDigest::value() which falls back to a
+ * linear scan if there is no digest for the tag list on the current thread. Therefore the
+ * checks can be called without a digest, e.g. by tests and benchmarks.
+ */
+class TagDigest {
+
+    static constexpr std::array<uint8_t, tag_digest::table_size> m_table = tag_digest::build_table();
+
+    /// digest made available by Scope on the current thread
+    static thread_local const TagDigest* m_current;
+
+    const osmium::TagList* m_tags = nullptr;
+
+    std::array<const char*, tag_digest_key_count> m_values {};
+
+    /// keys with a value in m_values and every_object
+    key_mask_type m_key_mask = every_object;
+
+public:
+    /**
+     * Make a digest available to TagDigest::value() on the current thread until the scope
+     * ends.
+     */
+    class Scope {
+        const TagDigest* m_previous;
+
+    public:
+        explicit Scope(const TagDigest& digest) noexcept :
+            m_previous(m_current) {
+            m_current = &digest;
+        }
+
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+
+        ~Scope() noexcept {
+            m_current = m_previous;
+        }
+    };
+
+    /**
+     * Check if no two keys of TagKey map to the same slot of the hash table.
+     */
+    static constexpr bool collision_free() noexcept {
+        for (size_t i = 0; i < tag_digest_key_count; ++i) {
+            if (m_table[tag_digest::hash(tag_digest_keys[i])] != i) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    /**
+     * Look up the TagKey of a key.
+     *
+     * \returns TagKey::count if the key is not part of TagKey
+     */
+    static TagKey key_id(const char* key) noexcept {
+        const uint8_t index = m_table[tag_digest::hash(key)];
+        if (index == tag_digest::empty_slot || std::strcmp(tag_digest_keys[index], key)) {
+            return TagKey::count;
+        }
+        return static_cast<TagKey>(index);
+    }
+
+    /**
+     * Walk the tags once and store the values of all keys in TagKey.
+     */
+    void update(const osmium::TagList& tags) noexcept;
+
+    /**
+     * Append the values of the keys in key_mask() to a vector in the order of TagKey.
+     */
+    void store(std::vector<const char*>& values) const;
+
+    /**
+     * Set the digest of a tag list from its key mask and the values saved by store().
+     *
+     * \param tags tag list
+     * \param key_mask key mask of the tag list
+     * \param values values of the keys in key_mask in the order of TagKey
+     */
+    void restore(const osmium::TagList& tags, const key_mask_type key_mask, const char* const* values) noexcept;
+
+    bool describes(const osmium::TagList& tags) const noexcept {
+        return m_tags == &tags;
+    }
+
+    /**
+     * Keys of TagKey present in the tag list. The bit every_object is always set.
+     */
+    key_mask_type key_mask() const noexcept {
+        return m_key_mask;
+    }
+
+    const char* get(const TagKey key) const noexcept {
+        return m_values[static_cast<size_t>(key)];
+    }
+
+    /**
+     * Get the value of a key using the digest of the tag list on the current thread if
+     * there is one.
+     *
+     * \param tags tag list
+     * \param key key to look up
+     * \param default_value value returned if the key is missing
+     */
+    static const char* value(const osmium::TagList& tags, const TagKey key,
+            const char* default_value = nullptr) noexcept {
+        const char* result = (m_current && m_current->describes(tags))
+            ? m_current->get(key)
+            : tags.get_value_by_key(tag_digest_keys[static_cast<size_t>(key)]);
+        return result ? result : default_value;
+    }
+
+    /**
+     * Check if the tag list contains a tag using the digest of the tag list on the current
+     * thread if there is one.
+     */
+    static bool has_tag(const osmium::TagList& tags, const TagKey key, const char* tag_value) noexcept {
+        const char* result = value(tags, key);
+        return result && !std::strcmp(result, tag_value);
+    }
+
+    /**
+     * Same as value() above for keys only known at run time. Keys which are not part of TagKey are
+     * looked up by a linear scan of the tag list.
+     */
+    static const char* value(const osmium::TagList& tags, const char* key,
+            const char* default_value = nullptr) noexcept {
+        const TagKey id = key_id(key);
+        if (id == TagKey::count) {
+            return tags.get_value_by_key(key, default_value);
+        }
+        return value(tags, id, default_value);
+    }
+};
+
+#endif /* SRC_TAG_DIGEST_HPP_ */
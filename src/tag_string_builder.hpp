@@ -0,0 +1,79 @@
+/*
+ * tag_string_builder.hpp
+ *
+ *  Created on:  2026-10-18
+ */
+
+#ifndef SRC_TAG_STRING_BUILDER_HPP_
+#define SRC_TAG_STRING_BUILDER_HPP_
+
+#include <array>
+#include <cstring>
+
+/**
+ * Builder of the strings of the "tags" fields (key=value pairs joined by a separator)
+ * in a buffer of fixed size.
+ *
+ * Each handler owns one builder and reuses it for every feature. Building the string does
+ * not allocate any memory.
+ *
+ * \tparam TCapacity size of the buffer including the terminating null character
+ */
+template <size_t TCapacity>
+class TagStringBuilder {
+
+    /// Tags whose key and value together are this long or longer are skipped.
+    static constexpr size_t max_tag_length = 48;
+
+    std::array<char, TCapacity> m_buffer;
+
+    size_t m_length = 0;
+
+public:
+    /**
+     * Start a new string.
+     */
+    void reset() noexcept {
+        m_length = 0;
+    }
+
+    /**
+     * Append key=value and a separator. The tag is skipped if key and value are too long or
+     * if the string would not fit into the buffer. Keys and values are never truncated.
+     */
+    void append(const char* key, const char* value, const char separator) noexcept {
+        const size_t key_length = std::strlen(key);
+        const size_t value_length = std::strlen(value);
+        const size_t add_length = key_length + value_length + 2;
+        if (add_length >= max_tag_length + 2 || m_length + add_length >= TCapacity) {
+            return;
+        }
+        char* out = m_buffer.data() + m_length;
+        std::memcpy(out, key, key_length);
+        out += key_length;
+        *out++ = '=';
+        std::memcpy(out, value, value_length);
+        out += value_length;
+        *out = separator;
+        m_length += add_length;
+    }
+
+    /**
+     * Remove the separator after the last tag and terminate the string.
+     *
+     * \returns the string, valid until the builder is reset
+     */
+    const char* finish() noexcept {
+        if (m_length > 0) {
+            --m_length;
+        }
+        m_buffer[m_length] = '\0';
+        return m_buffer.data();
+    }
+
+    size_t length() const noexcept {
+        return m_length;
+    }
+};
+
+#endif /* SRC_TAG_STRING_BUILDER_HPP_ */
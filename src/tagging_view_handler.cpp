@@ -18,6 +18,7 @@
  */
 
 #include "tagging_view_handler.hpp"
+#include "tag_digest.hpp"
 
 TaggingViewHandler::TaggingViewHandler(Options& options, CreateLayerFunc create_layer) :
         AbstractViewHandler(options),
@@ -85,6 +86,12 @@ TaggingViewHandler::TaggingViewHandler(Options& options, CreateLayerFunc create_
     m_tagging_long_text_ways->add_field("tags", OFTString, MAX_STRING_LENGTH);
     m_tagging_long_text_ways->add_field("lastchange", OFTString, 21);
     m_tagging_long_text_ways->add_field("text", OFTString, MAX_STRING_LENGTH);
+
+    // order has to match handle_object
+    for (const char* step : {"empty_value", "check_fixme", "empty_key", "unusual_character",
+            "check_key_length", "hidden_nonop", "no_main_tags", "long_text"}) {
+        m_check_counters.add(step);
+    }
 }
 
 void TaggingViewHandler::close() {
@@ -107,6 +114,9 @@ void TaggingViewHandler::close() {
 void TaggingViewHandler::write_feature_to_simple_layer(gdalcpp::Layer* layer,
         const osmium::OSMObject& object, const char* field_name, const char* value,
         const char* other_field_name, const char* other_value) {
+    if (selection_only()) {
+        return;
+    }
     try {
         std::unique_ptr<OGRGeometry> geometry;
         if (object.type() == osmium::item_type::node) {
@@ -123,20 +133,22 @@ void TaggingViewHandler::write_feature_to_simple_layer(gdalcpp::Layer* layer,
             }
             geometry = m_factory.create_linestring((way));
         }
-        gdalcpp::Feature feature(*layer, std::move(geometry));
+        OutputFeature feature(*layer, std::move(geometry));
         set_basic_fields(feature, object, field_name, value);
         if (other_field_name && other_value) {
             feature.set_field(other_field_name, other_value);
         }
-        feature.add_to_layer();
+        write_feature(feature);
     } catch (osmium::geometry_error& err) {
-        m_options.verbose_output << err.what() << "\n";
+        log_verbose(m_options.verbose_output, err.what(), "\n");
     }
 }
 
-/*static*/ void TaggingViewHandler::set_basic_fields(gdalcpp::Feature& feature, const osmium::OSMObject& object,
+/*static*/ void TaggingViewHandler::set_basic_fields(OutputFeature& feature, const osmium::OSMObject& object,
         const char* field_name, const char* value) {
-    static char idbuffer[20];
+    // Not static because relation managers of other views call this method from their own
+    // threads if --threads is used.
+    char idbuffer[20];
     sprintf(idbuffer, "%ld", object.id());
     if (object.type() == osmium::item_type::way) {
         feature.set_field("way_id", idbuffer);
@@ -176,9 +188,9 @@ bool TaggingViewHandler::add_fixme(gdalcpp::Layer* fixme_layer,
     const char* tag_value = object.tags().get_value_by_key(key.c_str());
     if (tag_value) {
         std::string tag = key + "=" + tag_value;
-        std::string other_tags = tags_string(object.tags(), key.c_str());
+        const char* other_tags = tags_string(object.tags(), key.c_str());
         write_feature_to_simple_layer(fixme_layer, object, "tag", tag.c_str(),
-                "other_tags", other_tags.c_str());
+                "other_tags", other_tags);
         return true;
     }
     return false;
@@ -212,9 +224,9 @@ void TaggingViewHandler::check_fixme(const osmium::OSMObject& object) {
             std::string tag = t.key();
             tag += "=";
             tag += tag_value;
-            std::string other_tags = tags_string(object.tags(), t.key());
+            const char* other_tags = tags_string(object.tags(), t.key());
             write_feature_to_simple_layer(current_layer, object, "tag", tag.c_str(),
-                    "other_tags", other_tags.c_str());
+                    "other_tags", other_tags);
             return;
         }
     }
@@ -306,6 +318,9 @@ void TaggingViewHandler::check_key_length(const osmium::OSMObject& object) {
 
 void TaggingViewHandler::write_missspelled(const osmium::OSMObject& object,
         const char* key, const char* error, const char* otherkey) {
+    if (selection_only()) {
+        return;
+    }
     gdalcpp::Layer* current_layer;
     std::unique_ptr<OGRGeometry> geometry;
     try {
@@ -321,15 +336,15 @@ void TaggingViewHandler::write_missspelled(const osmium::OSMObject& object,
         if (object.type() == osmium::item_type::way) {
         } else if (object.type() == osmium::item_type::node) {
         }
-        gdalcpp::Feature feature(*current_layer, std::move(geometry));
+        OutputFeature feature(*current_layer, std::move(geometry));
         set_basic_fields(feature, object, "key", key);
         feature.set_field("error", error);
         if (otherkey) {
             feature.set_field("otherkey", otherkey);
         }
-        feature.add_to_layer();
+        write_feature(feature);
     } catch (osmium::geometry_error& err) {
-        m_options.verbose_output << err.what() << "\n";
+        log_verbose(m_options.verbose_output, err.what(), "\n");
     }
 }
 
@@ -372,36 +387,36 @@ void TaggingViewHandler::hidden_nonop(const osmium::OSMObject& object) {
     if (!has_important_core_tag(object.tags())) {
         return;
     }
-    const char* disused = object.get_value_by_key("disused");
-    const char* abandoned = object.get_value_by_key("abandoned");
-    const char* razed = object.get_value_by_key("razed");
-    const char* dismantled = object.get_value_by_key("dismantled");
-    const char* construction = object.get_value_by_key("construction");
-    const char* proposed = object.get_value_by_key("proposed");
+    const char* disused = TagDigest::value(object.tags(), TagKey::disused);
+    const char* abandoned = TagDigest::value(object.tags(), TagKey::abandoned);
+    const char* razed = TagDigest::value(object.tags(), TagKey::razed);
+    const char* dismantled = TagDigest::value(object.tags(), TagKey::dismantled);
+    const char* construction = TagDigest::value(object.tags(), TagKey::construction);
+    const char* proposed = TagDigest::value(object.tags(), TagKey::proposed);
     if (!value_is_false(construction) && !valid_construction(construction)) {
-        write_feature_to_simple_layer(current_layer, object, "tags", tags_string(object.tags(), nullptr).c_str());
+        write_feature_to_simple_layer(current_layer, object, "tags", tags_string(object.tags(), nullptr));
         return;
     }
     if (!value_is_false(disused) || !value_is_false(abandoned) || !value_is_false(razed)
             || !value_is_false(dismantled) || !value_is_false(proposed)) {
-        write_feature_to_simple_layer(current_layer, object, "tags", tags_string(object.tags(), nullptr).c_str());
+        write_feature_to_simple_layer(current_layer, object, "tags", tags_string(object.tags(), nullptr));
     }
 }
 
 bool TaggingViewHandler::has_important_core_tag(const osmium::TagList& tags) {
-    const char* highway = tags.get_value_by_key("highway");
+    const char* highway = TagDigest::value(tags, TagKey::highway);
     if (highway && !is_nonop(highway)) {
         return true;
     }
-    const char* railway = tags.get_value_by_key("railway");
+    const char* railway = TagDigest::value(tags, TagKey::railway);
     if (railway && !is_nonop(railway)) {
         return true;
     }
-    const char* amenity = tags.get_value_by_key("amenity");
+    const char* amenity = TagDigest::value(tags, TagKey::amenity);
     if (amenity && !is_nonop(amenity)) {
         return true;
     }
-    const char* shop = tags.get_value_by_key("shop");
+    const char* shop = TagDigest::value(tags, TagKey::shop);
     if (shop && !is_nonop(shop)) {
         return true;
     }
@@ -584,7 +599,7 @@ void TaggingViewHandler::no_main_tags(const osmium::OSMObject& object) {
         return;
     }
     if (has_non_feature_key(object.tags())) {
-        write_feature_to_simple_layer(current_layer, object, "tags", tags_string(object.tags(), nullptr).c_str());
+        write_feature_to_simple_layer(current_layer, object, "tags", tags_string(object.tags(), nullptr));
     }
 }
 
@@ -618,33 +633,38 @@ void TaggingViewHandler::long_text(const osmium::OSMObject& object) {
         for (auto&& k : keys) {
             if (is_a_x_key_key(t.key(), k)) {
                 if (char_length_utf8(t.value()) > 150) {
-                    write_feature_to_simple_layer(current_layer, object, "tags", tags_string(object.tags(), t.key()).c_str(), "text", t.value());
+                    write_feature_to_simple_layer(current_layer, object, "tags", tags_string(object.tags(), t.key()), "text", t.value());
                 }
             }
         }
         if (is_a_x_key_key(t.key(), "name")) {
             if (char_length_utf8(t.value()) > 150) {
-                write_feature_to_simple_layer(current_layer, object, "tags", tags_string(object.tags(), t.key()).c_str(), "text", t.value());
+                write_feature_to_simple_layer(current_layer, object, "tags", tags_string(object.tags(), t.key()), "text", t.value());
             }
         }
     }
 }
 
 void TaggingViewHandler::handle_object(const osmium::OSMObject& object) {
-    empty_value(object);
-    check_fixme(object);
-    empty_key(object);
-    unusual_character(object);
-    check_key_length(object);
-    hidden_nonop(object);
-    no_main_tags(object);
-    long_text(object);
+    // The indexes are the order of registration in the constructor.
+    counted_step(0, [&]() { empty_value(object); });
+    counted_step(1, [&]() { check_fixme(object); });
+    counted_step(2, [&]() { empty_key(object); });
+    counted_step(3, [&]() { unusual_character(object); });
+    counted_step(4, [&]() { check_key_length(object); });
+    counted_step(5, [&]() { hidden_nonop(object); });
+    counted_step(6, [&]() { no_main_tags(object); });
+    counted_step(7, [&]() { long_text(object); });
 }
 
 ViewType TaggingViewHandler::view_type() const {
     return ViewType::tagging;
 }
 
+bool TaggingViewHandler::supports_selection() const {
+    return true;
+}
+
 std::string TaggingViewHandler::view_name() const {
     return "tagging";
 }
@@ -22,7 +22,7 @@
 
 #include "abstract_view_handler.hpp"
 
-class TaggingViewHandler : public AbstractViewHandler {
+class TaggingViewHandler final : public AbstractViewHandler {
 
     std::unique_ptr<gdalcpp::Layer> m_tagging_fixmes_on_nodes;
     std::unique_ptr<gdalcpp::Layer> m_tagging_fixmes_on_ways;
@@ -142,11 +142,6 @@ class TaggingViewHandler : public AbstractViewHandler {
      */
     void long_text(const osmium::OSMObject& object);
 
-    /**
-     * Check if a tag has a "feature" key, i.e. it has a key which describes what it is.
-     */
-    static bool has_feature_key(const osmium::TagList& tags, const osmium::item_type type);
-
     static bool has_non_feature_key(const osmium::TagList& tags);
 
     /**
@@ -154,9 +149,16 @@ class TaggingViewHandler : public AbstractViewHandler {
      */
     void handle_object(const osmium::OSMObject& object);
 
+    bool supports_selection() const;
+
 public:
     TaggingViewHandler() = delete;
 
+    /**
+     * Check if a tag has a "feature" key, i.e. it has a key which describes what it is.
+     */
+    static bool has_feature_key(const osmium::TagList& tags, const osmium::item_type type);
+
     explicit TaggingViewHandler(Options& options, CreateLayerFunc create_layer);
 
     static constexpr size_t MAX_STRING_LENGTH = 254;
@@ -185,7 +187,7 @@ public:
     /**
      * Set some basic fields of a feature: ID, lastchange and one freely selectable field
      */
-    static void set_basic_fields(gdalcpp::Feature& feature, const osmium::OSMObject& object,
+    static void set_basic_fields(OutputFeature& feature, const osmium::OSMObject& object,
             const char* field_name, const char* value);
 
     /**
@@ -7,10 +7,19 @@
 #include "tagging_view_handler.hpp"
 
 TurnRestrictionsManager::TurnRestrictionsManager(Options& options) :
-        OGROutputBase(options) {
+        OGROutputBase(options),
+        enabled(false) {
     init_vehicle_classes_lengths();
 }
 
+void TurnRestrictionsManager::enable() {
+    enabled = true;
+}
+
+void TurnRestrictionsManager::set_relation_filter(const id_set_type* filter) {
+    relation_filter = filter;
+}
+
 std::string TurnRestrictionsManager::view_name() {
     return "turn_restrictions";
 }
@@ -22,6 +31,13 @@ void TurnRestrictionsManager::init_vehicle_classes_lengths() {
 }
 
 bool TurnRestrictionsManager::new_relation(const osmium::Relation& relation) const noexcept {
+    if (!enabled || (relation_filter && !relation_filter->get(relation.positive_id()))) {
+        return false;
+    }
+    // Relations are distributed over the shards by their ID.
+    if (m_options.shard_count > 1 && relation.positive_id() % m_options.shard_count != m_options.shard_index) {
+        return false;
+    }
     const char* type = relation.get_value_by_key("type");
     if (type && !strcmp(type, "restriction")) {
         return true;
@@ -47,33 +63,33 @@ bool TurnRestrictionsManager::new_member(const osmium::Relation&,
 void TurnRestrictionsManager::write_invalid_point(const osmium::Relation& relation,
         const ValidationResult& result, std::unique_ptr<OGRGeometry>&& geometry,
         bool present_in_line_layer) {
-    gdalcpp::Feature feature(*(m_invalid_restrictions_n.get()), std::move(geometry));
+    OutputFeature feature(*(m_invalid_restrictions_n.get()), std::move(geometry));
     TaggingViewHandler::set_basic_fields(feature, relation, "message", result.message.value().c_str());
     feature.set_field("has_line_geom", present_in_line_layer ? 1 : 0);
-    feature.add_to_layer();
+    write_feature(feature);
 }
 
 void TurnRestrictionsManager::write_invalid_line(const osmium::Relation& relation,
         const ValidationResult& result, std::unique_ptr<OGRGeometry>&& geometry) {
-    gdalcpp::Feature feature(*(m_invalid_restrictions_w.get()), std::move(geometry));
+    OutputFeature feature(*(m_invalid_restrictions_w.get()), std::move(geometry));
     TaggingViewHandler::set_basic_fields(feature, relation, "message", result.message.value().c_str());
     feature.set_field("error_type", osmium::item_type_to_name(result.object_type));
     feature.set_field("error_id", static_cast<GIntBig>(result.object_id));
-    feature.add_to_layer();
+    write_feature(feature);
 }
 
 void TurnRestrictionsManager::write_valid(const osmium::Relation& relation,
         std::unique_ptr<OGRGeometry>&& point, std::unique_ptr<OGRGeometry>&& multilinestring) {
     const char* r_value = relation.get_value_by_key("restriction");
     {
-        gdalcpp::Feature feature(*(m_restrictions_w.get()), std::move(multilinestring));
+        OutputFeature feature(*(m_restrictions_w.get()), std::move(multilinestring));
         TaggingViewHandler::set_basic_fields(feature, relation, "restriction", r_value);
-        feature.add_to_layer();
+        write_feature(feature);
     }
     if (point && !point->IsEmpty()) {
-        gdalcpp::Feature feature(*(m_restrictions_n.get()), std::move(point));
+        OutputFeature feature(*(m_restrictions_n.get()), std::move(point));
         TaggingViewHandler::set_basic_fields(feature, relation, "restriction", r_value);
-        feature.add_to_layer();
+        write_feature(feature);
     }
 }
 
@@ -9,6 +9,7 @@
 #include <gdalcpp.hpp>
 #include <osmium/relations/relations_manager.hpp>
 #include "ogr_output_base.hpp"
+#include "selective_node_locations.hpp"
 #include "turn_restriction.hpp"
 
 class TurnRestrictionsManager : public osmium::relations::RelationsManager<TurnRestrictionsManager,
@@ -21,6 +22,11 @@ true, true, true>, public OGROutputBase {
 
     static constexpr size_t vehicle_classes_count = 42;
 
+    bool enabled;
+
+    /// If set, only relations whose ID is in this set are collected.
+    const id_set_type* relation_filter = nullptr;
+
     void write_invalid_point(const osmium::Relation& relation,
             const ValidationResult& result, std::unique_ptr<OGRGeometry>&& geometry,
             bool present_in_line_layer);
@@ -74,6 +80,21 @@ public:
 
     explicit TurnRestrictionsManager(Options& options);
 
+    /**
+     * Activate this relation manager.
+     *
+     * This method has to be called before the manager is used. Otherwise no relations are
+     * collected.
+     */
+    void enable();
+
+    /**
+     * Collect only relations whose ID is in the provided set.
+     *
+     * This method has to be called before the first pass.
+     */
+    void set_relation_filter(const id_set_type* filter);
+
     static std::string view_name();
 
     static constexpr const char* node_layer_name = "restriction_n";
@@ -0,0 +1,36 @@
+/*
+ * verbose_log.hpp
+ *
+ *  Created on:  2026-10-18
+ */
+
+#ifndef SRC_VERBOSE_LOG_HPP_
+#define SRC_VERBOSE_LOG_HPP_
+
+#include <mutex>
+#include <sstream>
+
+#include <osmium/util/verbose_output.hpp>
+
+/// serialises the messages written by log_verbose()
+inline std::mutex verbose_output_mutex;
+
+/**
+ * Write a message to the verbose output.
+ *
+ * osmium::util::VerboseOutput is not thread-safe. Code which may run on a view worker thread
+ * (see ViewWorkerPool) has to use this function instead of writing to the verbose output
+ * directly. The message is built first and written as a whole while holding a lock.
+ */
+template <typename... TArgs>
+void log_verbose(osmium::util::VerboseOutput& verbose_output, const TArgs&... args) {
+    if (!verbose_output.verbose()) {
+        return;
+    }
+    std::ostringstream message;
+    (message << ... << args);
+    std::lock_guard<std::mutex> lock {verbose_output_mutex};
+    verbose_output << message.str();
+}
+
+#endif /* SRC_VERBOSE_LOG_HPP_ */
@@ -0,0 +1,96 @@
+/*
+ * view_worker_pool.cpp
+ *
+ *  Created on:  2026-10-18
+ */
+
+#include <algorithm>
+
+#include "view_worker_pool.hpp"
+
+ViewWorkerPool::Worker::Worker(const size_t queue_size) :
+        views(),
+        queue(queue_size, "view_worker"),
+        thread(),
+        exception() { }
+
+ViewWorkerPool::ViewWorkerPool(HandlerCollection& handlers, const std::vector<ViewType>& views,
+        const size_t thread_count, const size_t queue_size) :
+        m_handlers(handlers),
+        m_workers() {
+    std::vector<ViewType> unique_views;
+    for (auto vt : views) {
+        if (std::find(unique_views.begin(), unique_views.end(), vt) == unique_views.end()) {
+            unique_views.push_back(vt);
+        }
+    }
+    const size_t worker_count = std::max<size_t>(1, std::min(thread_count, unique_views.size()));
+    for (size_t i = 0; i < worker_count; ++i) {
+        m_workers.emplace_back(new Worker(queue_size));
+    }
+    for (size_t i = 0; i < unique_views.size(); ++i) {
+        m_workers.at(i % worker_count)->views.push_back(unique_views.at(i));
+    }
+    for (auto& w : m_workers) {
+        Worker& worker = *w;
+        worker.thread = std::thread([this, &worker]() {
+            run(worker);
+        });
+    }
+}
+
+ViewWorkerPool::~ViewWorkerPool() {
+    if (!m_finished) {
+        stop_workers();
+    }
+}
+
+void ViewWorkerPool::run(Worker& worker) {
+    while (true) {
+        buffer_ptr buffer;
+        worker.queue.wait_and_pop(buffer);
+        if (!buffer) {
+            return;
+        }
+        // Keep on consuming the queue after a failure. Otherwise the reading thread would block
+        // forever if the queue is full.
+        if (worker.exception) {
+            continue;
+        }
+        try {
+            for (auto vt : worker.views) {
+                m_handlers.apply_to_view(vt, *buffer);
+            }
+        } catch (...) {
+            worker.exception = std::current_exception();
+        }
+    }
+}
+
+void ViewWorkerPool::push(osmium::memory::Buffer&& buffer) {
+    buffer_ptr ptr = std::make_shared<const osmium::memory::Buffer>(std::move(buffer));
+    for (auto& w : m_workers) {
+        w->queue.push(ptr);
+    }
+}
+
+void ViewWorkerPool::stop_workers() {
+    m_finished = true;
+    for (auto& w : m_workers) {
+        w->queue.push(buffer_ptr{});
+    }
+    for (auto& w : m_workers) {
+        if (w->thread.joinable()) {
+            w->thread.join();
+        }
+    }
+}
+
+void ViewWorkerPool::finish() {
+    stop_workers();
+    for (auto& w : m_workers) {
+        if (w->exception) {
+            std::rethrow_exception(w->exception);
+        }
+    }
+}
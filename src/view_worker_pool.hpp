@@ -0,0 +1,87 @@
+/*
+ * view_worker_pool.hpp
+ *
+ *  Created on:  2026-10-18
+ */
+
+#ifndef SRC_VIEW_WORKER_POOL_HPP_
+#define SRC_VIEW_WORKER_POOL_HPP_
+
+#include <exception>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include <osmium/memory/buffer.hpp>
+#include <osmium/thread/queue.hpp>
+
+#include "handler_collection.hpp"
+#include "options.hpp"
+
+/**
+ * Run the views of a HandlerCollection on worker threads.
+ *
+ * The caller reads the input file, adds node locations to the ways and hands the
+ * buffers over to the pool. Every view is assigned to exactly one worker thread and
+ * every worker processes all buffers in the order they were pushed. Therefore the order of
+ * the features in each output layer is the same as in single-threaded operation.
+ */
+class ViewWorkerPool {
+
+public:
+    using buffer_ptr = std::shared_ptr<const osmium::memory::Buffer>;
+
+private:
+    struct Worker {
+        /// views processed by this worker
+        std::vector<ViewType> views;
+        /// Incoming buffers. An empty pointer signals the end of the input.
+        osmium::thread::Queue<buffer_ptr> queue;
+        std::thread thread;
+        /// first exception thrown by a handler of this worker
+        std::exception_ptr exception;
+
+        explicit Worker(const size_t queue_size);
+    };
+
+    HandlerCollection& m_handlers;
+
+    std::vector<std::unique_ptr<Worker>> m_workers;
+
+    bool m_finished = false;
+
+    void run(Worker& worker);
+
+    void stop_workers();
+
+public:
+    ViewWorkerPool() = delete;
+
+    /**
+     * \param handlers handler collection with all handlers and relation managers already set up
+     * \param views views to be processed
+     * \param thread_count maximum number of worker threads. The number of threads does not
+     *        exceed the number of views.
+     * \param queue_size maximum number of buffers waiting in the queue of a worker
+     */
+    ViewWorkerPool(HandlerCollection& handlers, const std::vector<ViewType>& views,
+            const size_t thread_count, const size_t queue_size = 20);
+
+    ~ViewWorkerPool();
+
+    /**
+     * Hand a buffer over to all workers. Locations of way nodes must be set already.
+     *
+     * This method blocks if the queue of a worker is full.
+     */
+    void push(osmium::memory::Buffer&& buffer);
+
+    /**
+     * Wait until all workers are done.
+     *
+     * If a handler threw an exception, it is rethrown here.
+     */
+    void finish();
+};
+
+#endif /* SRC_VIEW_WORKER_POOL_HPP_ */
@@ -0,0 +1,119 @@
+/*
+ * way_batch.hpp
+ *
+ *  Created on:  2026-10-18
+ */
+
+#ifndef SRC_WAY_BATCH_HPP_
+#define SRC_WAY_BATCH_HPP_
+
+#include <string>
+#include <vector>
+
+#include <osmium/osm/location.hpp>
+#include <osmium/osm/way.hpp>
+
+#include "tag_digest.hpp"
+
+/**
+ * Ways of one buffer passed to a handler at once (see AbstractViewHandler::way_batch).
+ *
+ * The batch keeps the key mask and the values of the keys of TagKey of each way instead of
+ * a copy of its whole TagDigest. The digest is rebuilt from them when a step visits the way.
+ * A handler can run one check over all ways of the batch before it runs the next one. The
+ * ways are only valid as long as the buffer they were read from.
+ */
+class WayBatch {
+
+    struct Entry {
+        const osmium::Way* way;
+
+        /// key mask of the tag digest of the way
+        key_mask_type key_mask;
+
+        /// offset of the values of the keys in key_mask in m_values
+        size_t values_offset;
+    };
+
+    std::vector<Entry> m_entries;
+
+    /// values of the digests of all ways, see TagDigest::store()
+    std::vector<const char*> m_values;
+
+    /// ways whose geometry could not be built, later steps skip them
+    std::vector<bool> m_failed;
+
+    /// messages of the osmium::invalid_location exceptions thrown by the steps
+    std::vector<std::string> m_errors;
+
+    /// digest of the way visited by the current step
+    TagDigest m_digest;
+
+public:
+    /**
+     * Remove all ways. The memory is kept for the next batch.
+     */
+    void clear() noexcept {
+        m_entries.clear();
+        m_values.clear();
+        m_failed.clear();
+        m_errors.clear();
+    }
+
+    /**
+     * Add a way and the digest of its tags.
+     */
+    void add(const osmium::Way& way, const TagDigest& digest) {
+        m_entries.push_back(Entry{&way, digest.key_mask(), m_values.size()});
+        digest.store(m_values);
+        m_failed.push_back(false);
+    }
+
+    size_t size() const noexcept {
+        return m_entries.size();
+    }
+
+    bool empty() const noexcept {
+        return m_entries.empty();
+    }
+
+    bool failed(const size_t index) const {
+        return m_failed.at(index);
+    }
+
+    key_mask_type key_mask(const size_t index) const {
+        return m_entries.at(index).key_mask;
+    }
+
+    const std::vector<std::string>& errors() const noexcept {
+        return m_errors;
+    }
+
+    /**
+     * Run a step for all ways of the batch in their order.
+     *
+     * The step is called with the way and its index in the batch. The digest of the way
+     * is available to TagDigest::value() during the call. If the step throws
+     * osmium::invalid_location, the error is recorded and the way is skipped by all later
+     * steps. This matches the handling of single ways by HandlerCollection.
+     */
+    template <typename TStep>
+    void for_each(TStep&& step) {
+        for (size_t i = 0; i < m_entries.size(); ++i) {
+            if (m_failed[i]) {
+                continue;
+            }
+            const Entry& entry = m_entries[i];
+            m_digest.restore(entry.way->tags(), entry.key_mask, m_values.data() + entry.values_offset);
+            TagDigest::Scope digest_scope {m_digest};
+            try {
+                step(*entry.way, i);
+            } catch (osmium::invalid_location& err) {
+                m_failed[i] = true;
+                m_errors.emplace_back(err.what());
+            }
+        }
+    }
+};
+
+#endif /* SRC_WAY_BATCH_HPP_ */
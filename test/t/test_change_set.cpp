@@ -0,0 +1,86 @@
+/*
+ *  © 2026 Geofabrik GmbH
+ *
+ *  This file is part of osmi_simple_views.
+ *
+ *  osmi_simple_views is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  osmi_simple_views is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with osmi_simple_views. If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "catch.hpp"
+
+#include <osmium/builder/attr.hpp>
+#include <osmium/io/writer.hpp>
+#include <osmium/io/xml_output.hpp>
+#include <osmium/memory/buffer.hpp>
+#include <osmium/visitor.hpp>
+
+#include <change_set.hpp>
+
+/**
+ * Write a change file modifying node 1, way 20 and relation 30.
+ */
+void write_change_file(const std::string& filename) {
+    using namespace osmium::builder::attr;
+    osmium::memory::Buffer buffer {1024, osmium::memory::Buffer::auto_grow::yes};
+    osmium::builder::add_node(buffer, _id(1), _version(2), _location(9.0, 50.0));
+    osmium::builder::add_way(buffer, _id(20), _version(2), _node(7), _node(8), _tag("highway", "primary"));
+    osmium::builder::add_relation(buffer, _id(30), _version(2), _member(osmium::item_type::way, 11),
+            _tag("type", "route"));
+    osmium::io::Writer writer {osmium::io::File{filename, "osc"}, osmium::io::overwrite::allow};
+    writer(std::move(buffer));
+    writer.close();
+}
+
+TEST_CASE("objects affected by changes") {
+    write_change_file("test_change_set.osc");
+    ChangeSet change_set;
+    change_set.read_changes("test_change_set.osc");
+
+    // state after the changes
+    using namespace osmium::builder::attr;
+    osmium::memory::Buffer buffer {1024, osmium::memory::Buffer::auto_grow::yes};
+    osmium::builder::add_way(buffer, _id(10), _node(1), _node(2));
+    osmium::builder::add_way(buffer, _id(11), _node(3), _node(4));
+    osmium::builder::add_way(buffer, _id(12), _node(5), _node(6));
+    osmium::builder::add_way(buffer, _id(20), _node(7), _node(8));
+    osmium::builder::add_relation(buffer, _id(30), _member(osmium::item_type::way, 11));
+    osmium::builder::add_relation(buffer, _id(31), _member(osmium::item_type::way, 12));
+    osmium::builder::add_relation(buffer, _id(32), _member(osmium::item_type::way, 10));
+    osmium::builder::add_relation(buffer, _id(33), _member(osmium::item_type::way, 11));
+    osmium::builder::add_relation(buffer, _id(34), _member(osmium::item_type::node, 1));
+    osmium::builder::add_relation(buffer, _id(35), _member(osmium::item_type::relation, 30));
+    osmium::apply(buffer, change_set);
+
+    CHECK(change_set.changed_nodes().get(1));
+    CHECK_FALSE(change_set.changed_nodes().get(2));
+
+    SECTION("ways") {
+        // changed node
+        CHECK(change_set.affected_ways().get(10));
+        // member of a changed relation
+        CHECK(change_set.affected_ways().get(11));
+        CHECK_FALSE(change_set.affected_ways().get(12));
+        // changed way
+        CHECK(change_set.affected_ways().get(20));
+    }
+
+    SECTION("relations") {
+        CHECK(change_set.affected_relations().get(30));
+        CHECK_FALSE(change_set.affected_relations().get(31));
+        CHECK(change_set.affected_relations().get(32));
+        // Way 11 is only affected because it is a member of relation 30.
+        CHECK_FALSE(change_set.affected_relations().get(33));
+        CHECK(change_set.affected_relations().get(34));
+        CHECK(change_set.affected_relations().get(35));
+    }
+}
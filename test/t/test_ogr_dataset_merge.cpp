@@ -0,0 +1,177 @@
+/*
+ *  © 2026 Geofabrik GmbH
+ *
+ *  This file is part of osmi_simple_views.
+ *
+ *  osmi_simple_views is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  osmi_simple_views is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with osmi_simple_views. If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "catch.hpp"
+
+#include <algorithm>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <stdlib.h>
+#include <unistd.h>
+
+#include <gdalcpp.hpp>
+#include <gdal_priv.h>
+#include <ogrsf_frmts.h>
+
+#include <ogr_dataset_merge.hpp>
+#include <shard_runner.hpp>
+
+/**
+ * Create a new directory in the working directory.
+ */
+std::string make_directory(const std::string& prefix) {
+    std::string directory = prefix + "-XXXXXX";
+    REQUIRE(mkdtemp(&directory[0]));
+    return directory;
+}
+
+/**
+ * Write a dataset with one point per way ID to layer "roads".
+ */
+void write_dataset(const std::string& filename, const std::vector<int>& way_ids) {
+    gdalcpp::Dataset dataset {"SQlite", filename, gdalcpp::SRS{4326}};
+    gdalcpp::Layer layer {dataset, "roads", wkbPoint};
+    layer.add_field("way_id", OFTInteger, 10);
+    for (const int id : way_ids) {
+        gdalcpp::Feature feature {layer, std::unique_ptr<OGRPoint>{new OGRPoint{9.0, 50.0}}};
+        feature.set_field("way_id", id);
+        feature.add_to_layer();
+    }
+}
+
+/**
+ * Read the way IDs of all features of layer "roads" of a dataset, sorted.
+ */
+std::vector<int> read_way_ids(const std::string& filename) {
+    GDALDataset* dataset = static_cast<GDALDataset*>(GDALOpenEx(filename.c_str(),
+            GDAL_OF_VECTOR | GDAL_OF_READONLY, nullptr, nullptr, nullptr));
+    REQUIRE(dataset);
+    OGRLayer* layer = dataset->GetLayerByName("roads");
+    REQUIRE(layer);
+    const int index = layer->GetLayerDefn()->GetFieldIndex("way_id");
+    std::vector<int> ids;
+    layer->ResetReading();
+    OGRFeature* feature;
+    while ((feature = layer->GetNextFeature()) != nullptr) {
+        ids.push_back(static_cast<int>(feature->GetFieldAsInteger64(index)));
+        OGRFeature::DestroyFeature(feature);
+    }
+    GDALClose(static_cast<GDALDatasetH>(dataset));
+    std::sort(ids.begin(), ids.end());
+    return ids;
+}
+
+bool exists(const std::string& path) {
+    return access(path.c_str(), F_OK) == 0;
+}
+
+TEST_CASE("shard of a location") {
+    SECTION("not sharded") {
+        CHECK(location_shard(osmium::Location{179.9, 10.0}, 1) == 0);
+    }
+    SECTION("longitude bands of equal width") {
+        CHECK(location_shard(osmium::Location{-180.0, 10.0}, 4) == 0);
+        CHECK(location_shard(osmium::Location{-90.1, 10.0}, 4) == 0);
+        CHECK(location_shard(osmium::Location{-90.0, 10.0}, 4) == 1);
+        CHECK(location_shard(osmium::Location{-0.1, -45.0}, 4) == 1);
+        CHECK(location_shard(osmium::Location{0.0, 80.0}, 4) == 2);
+        CHECK(location_shard(osmium::Location{90.0, 10.0}, 4) == 3);
+    }
+    SECTION("eastern edge belongs to the last shard") {
+        CHECK(location_shard(osmium::Location{180.0, 10.0}, 4) == 3);
+        CHECK(location_shard(osmium::Location{180.0, 10.0}, 3) == 2);
+    }
+    SECTION("invalid location belongs to the first shard") {
+        CHECK(location_shard(osmium::Location{}, 4) == 0);
+    }
+}
+
+TEST_CASE("merge shard directories") {
+    osmium::util::VerboseOutput verbose_output {false};
+    const std::string destination = make_directory("test_merge_shards");
+
+    SECTION("datasets with the same name are merged") {
+        const std::string shard0 = make_directory(destination + "/.shard-0");
+        const std::string shard1 = make_directory(destination + "/.shard-1");
+        const std::string shard2 = make_directory(destination + "/.shard-2");
+        write_dataset(shard0 + "/highways.db", {1, 2});
+        write_dataset(shard1 + "/highways.db", {3});
+        write_dataset(shard1 + "/tagging.db", {4});
+        write_dataset(shard2 + "/highways.db", {});
+        write_dataset(shard2 + "/tagging.db", {5});
+        const std::vector<std::string> files = merge_shard_directories({shard0, shard1, shard2}, destination,
+                verbose_output);
+        REQUIRE(files.size() == 2);
+        CHECK(files.at(0) == destination + "/highways.db");
+        CHECK(files.at(1) == destination + "/tagging.db");
+        CHECK(read_way_ids(destination + "/highways.db") == std::vector<int>({1, 2, 3}));
+        CHECK(read_way_ids(destination + "/tagging.db") == std::vector<int>({4, 5}));
+        CHECK_FALSE(exists(shard0));
+        CHECK_FALSE(exists(shard1));
+        CHECK_FALSE(exists(shard2));
+    }
+
+    SECTION("existing dataset in the destination directory") {
+        const std::string shard0 = make_directory(destination + "/.shard-0");
+        write_dataset(destination + "/highways.db", {1});
+        write_dataset(shard0 + "/highways.db", {2});
+        CHECK_THROWS_AS(merge_shard_directories({shard0}, destination, verbose_output), std::runtime_error&);
+        // Nothing is overwritten.
+        CHECK(read_way_ids(destination + "/highways.db") == std::vector<int>({1}));
+        CHECK(read_way_ids(shard0 + "/highways.db") == std::vector<int>({2}));
+    }
+}
+
+TEST_CASE("merge dataset") {
+    osmium::util::VerboseOutput verbose_output {false};
+    const std::string directory = make_directory("test_merge_dataset");
+    write_dataset(directory + "/destination.db", {1, 2, 3});
+    write_dataset(directory + "/source.db", {2, 4});
+
+    SECTION("replaced features are deleted") {
+        std::vector<osmium::object_id_type> queried;
+        auto replaced = [&queried](const osmium::item_type type, const osmium::object_id_type id) {
+            REQUIRE(type == osmium::item_type::way);
+            queried.push_back(id);
+            return id == 2 || id == 3;
+        };
+        merge_dataset(directory + "/source.db", directory + "/destination.db", replaced, verbose_output);
+        CHECK(read_way_ids(directory + "/destination.db") == std::vector<int>({1, 2, 4}));
+        // Only the features of the destination are checked.
+        std::sort(queried.begin(), queried.end());
+        CHECK(queried == std::vector<osmium::object_id_type>({1, 2, 3}));
+        // The source is not modified.
+        CHECK(read_way_ids(directory + "/source.db") == std::vector<int>({2, 4}));
+    }
+
+    SECTION("nothing is deleted without a function") {
+        merge_dataset(directory + "/source.db", directory + "/destination.db", nullptr, verbose_output);
+        CHECK(read_way_ids(directory + "/destination.db") == std::vector<int>({1, 2, 2, 3, 4}));
+    }
+
+    SECTION("missing layer") {
+        {
+            gdalcpp::Dataset dataset {"SQlite", directory + "/other.db", gdalcpp::SRS{4326}};
+            gdalcpp::Layer layer {dataset, "other", wkbPoint};
+        }
+        CHECK_THROWS_AS(merge_dataset(directory + "/destination.db", directory + "/other.db", nullptr, verbose_output),
+                std::runtime_error&);
+    }
+}
@@ -0,0 +1,85 @@
+/*
+ *  © 2026 Geofabrik GmbH
+ *
+ *  This file is part of osmi_simple_views.
+ *
+ *  osmi_simple_views is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  osmi_simple_views is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with osmi_simple_views. If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "catch.hpp"
+
+#include <osmium/builder/attr.hpp>
+#include <osmium/io/any_input.hpp>
+#include <osmium/io/pbf_output.hpp>
+#include <osmium/io/writer.hpp>
+#include <osmium/memory/buffer.hpp>
+
+#include <relation_blocks.hpp>
+
+/**
+ * Write a file with nodes, ways and relations. The PBF writer starts a new block whenever
+ * the type changes.
+ */
+void write_test_file(const std::string& filename, const bool sorted) {
+    using namespace osmium::builder::attr;
+    osmium::memory::Buffer buffer {1024, osmium::memory::Buffer::auto_grow::yes};
+    osmium::builder::add_node(buffer, _id(1), _location(9.0, 50.0));
+    osmium::builder::add_node(buffer, _id(2), _location(9.1, 50.1));
+    osmium::builder::add_way(buffer, _id(10), _nodes({1, 2}), _tag("highway", "residential"));
+    osmium::builder::add_relation(buffer, _id(20), _member(osmium::item_type::way, 10, "from"),
+            _tag("type", "restriction"));
+    osmium::builder::add_relation(buffer, _id(21), _member(osmium::item_type::relation, 20),
+            _tag("type", "route"));
+    osmium::io::Header header;
+    if (sorted) {
+        header.set("sorting", "Type_then_ID");
+    }
+    osmium::io::Writer writer {filename, header, osmium::io::overwrite::allow};
+    writer(std::move(buffer));
+    writer.close();
+}
+
+TEST_CASE("extract relation blocks") {
+
+    SECTION("sorted file") {
+        write_test_file("test_relation_blocks_sorted.osm.pbf", true);
+        const std::string data = extract_relation_blocks("test_relation_blocks_sorted.osm.pbf");
+        REQUIRE_FALSE(data.empty());
+        osmium::io::Reader reader {osmium::io::File{data.data(), data.size(), "pbf"}};
+        size_t nodes = 0;
+        size_t ways = 0;
+        std::vector<osmium::object_id_type> relations;
+        while (osmium::memory::Buffer buffer = reader.read()) {
+            nodes += std::distance(buffer.select<osmium::Node>().begin(), buffer.select<osmium::Node>().end());
+            ways += std::distance(buffer.select<osmium::Way>().begin(), buffer.select<osmium::Way>().end());
+            for (const osmium::Relation& relation : buffer.select<osmium::Relation>()) {
+                relations.push_back(relation.id());
+            }
+        }
+        reader.close();
+        CHECK(nodes == 0);
+        CHECK(ways == 0);
+        REQUIRE(relations.size() == 2);
+        CHECK(relations.at(0) == 20);
+        CHECK(relations.at(1) == 21);
+    }
+
+    SECTION("unsorted file") {
+        write_test_file("test_relation_blocks_unsorted.osm.pbf", false);
+        CHECK(extract_relation_blocks("test_relation_blocks_unsorted.osm.pbf").empty());
+    }
+
+    SECTION("missing file") {
+        CHECK_THROWS_AS(extract_relation_blocks("test_relation_blocks_missing.osm.pbf"), std::runtime_error&);
+    }
+}
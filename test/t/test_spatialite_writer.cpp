@@ -0,0 +1,97 @@
+/*
+ *  © 2026 Geofabrik GmbH
+ *
+ *  This file is part of osmi_simple_views.
+ *
+ *  osmi_simple_views is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  osmi_simple_views is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with osmi_simple_views. If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "catch.hpp"
+
+#include <cstring>
+
+#include <spatialite_writer.hpp>
+
+template <typename T>
+T read_blob(const std::string& blob, const size_t offset) {
+    T value;
+    std::memcpy(&value, blob.data() + offset, sizeof(T));
+    return value;
+}
+
+TEST_CASE("SpatiaLite blob of a point") {
+    OGRPoint point {9.5, 48.25};
+    std::string blob;
+    SpatialiteWriter::build_blob(point, 4326, blob);
+    // header (39 bytes), class (4 bytes), coordinates (16 bytes), end marker
+    REQUIRE(blob.size() == 60);
+    CHECK(blob[0] == 0x00);
+    CHECK(read_blob<int32_t>(blob, 2) == 4326);
+    CHECK(read_blob<double>(blob, 6) == 9.5);
+    CHECK(read_blob<double>(blob, 14) == 48.25);
+    CHECK(read_blob<double>(blob, 22) == 9.5);
+    CHECK(read_blob<double>(blob, 30) == 48.25);
+    CHECK(static_cast<unsigned char>(blob[38]) == 0x7C);
+    CHECK(read_blob<int32_t>(blob, 39) == 1);
+    CHECK(read_blob<double>(blob, 43) == 9.5);
+    CHECK(read_blob<double>(blob, 51) == 48.25);
+    CHECK(static_cast<unsigned char>(blob[59]) == 0xFE);
+}
+
+TEST_CASE("SpatiaLite blob of a linestring") {
+    OGRLineString linestring;
+    linestring.addPoint(1.0, 5.0);
+    linestring.addPoint(3.0, 2.0);
+    linestring.addPoint(-1.0, 4.0);
+    std::string blob;
+    SpatialiteWriter::build_blob(linestring, 3857, blob);
+    REQUIRE(blob.size() == 39 + 4 + 4 + 3 * 16 + 1);
+    CHECK(read_blob<int32_t>(blob, 2) == 3857);
+    // bounding box
+    CHECK(read_blob<double>(blob, 6) == -1.0);
+    CHECK(read_blob<double>(blob, 14) == 2.0);
+    CHECK(read_blob<double>(blob, 22) == 3.0);
+    CHECK(read_blob<double>(blob, 30) == 5.0);
+    CHECK(read_blob<int32_t>(blob, 39) == 2);
+    CHECK(read_blob<int32_t>(blob, 43) == 3);
+    CHECK(read_blob<double>(blob, 47) == 1.0);
+    CHECK(read_blob<double>(blob, 87) == 4.0);
+}
+
+TEST_CASE("SpatiaLite blob of a multipolygon") {
+    OGRLinearRing ring;
+    ring.addPoint(0.0, 0.0);
+    ring.addPoint(1.0, 0.0);
+    ring.addPoint(1.0, 1.0);
+    ring.addPoint(0.0, 0.0);
+    OGRPolygon polygon;
+    polygon.addRing(&ring);
+    OGRMultiPolygon multipolygon;
+    multipolygon.addGeometry(&polygon);
+    std::string blob;
+    SpatialiteWriter::build_blob(multipolygon, 4326, blob);
+    // class, number of polygons, entity marker, class, number of rings, number of points, points
+    REQUIRE(blob.size() == 39 + 4 + 4 + 1 + 4 + 4 + 4 + 4 * 16 + 1);
+    CHECK(read_blob<int32_t>(blob, 39) == 6);
+    CHECK(read_blob<int32_t>(blob, 43) == 1);
+    CHECK(static_cast<unsigned char>(blob[47]) == 0x69);
+    CHECK(read_blob<int32_t>(blob, 48) == 3);
+    CHECK(read_blob<int32_t>(blob, 52) == 1);
+    CHECK(read_blob<int32_t>(blob, 56) == 4);
+}
+
+TEST_CASE("SpatiaLite blob of unsupported geometry types") {
+    OGRGeometryCollection collection;
+    std::string blob;
+    REQUIRE_THROWS(SpatialiteWriter::build_blob(collection, 4326, blob));
+}
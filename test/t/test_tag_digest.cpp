@@ -0,0 +1,99 @@
+/*
+ *  © 2026 Geofabrik GmbH
+ *
+ *  This file is part of osmi_simple_views.
+ *
+ *  osmi_simple_views is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  osmi_simple_views is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with osmi_simple_views. If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "catch.hpp"
+
+#include <osmium/builder/attr.hpp>
+#include <osmium/memory/buffer.hpp>
+#include <osmium/osm/way.hpp>
+
+#include <tag_digest.hpp>
+
+TEST_CASE("tag digest") {
+    using namespace osmium::builder::attr;
+    osmium::memory::Buffer buffer {1024, osmium::memory::Buffer::auto_grow::yes};
+    const size_t offset = osmium::builder::add_way(buffer, _id(1), _tag("highway", "primary"),
+            _tag("name", "Hauptstraße"), _tag("turn:lanes", "left|through"), _tag("fixme", "check"));
+    const osmium::TagList& tags = buffer.get<osmium::Way>(offset).tags();
+
+    SECTION("all keys have their own slot") {
+        REQUIRE(TagDigest::collision_free());
+        for (size_t i = 0; i < tag_digest_key_count; ++i) {
+            CHECK(TagDigest::key_id(tag_digest_keys.at(i)) == static_cast<TagKey>(i));
+        }
+        CHECK(TagDigest::key_id("highway:") == TagKey::count);
+        CHECK(TagDigest::key_id("fixme") == TagKey::count);
+    }
+
+    SECTION("values from the digest") {
+        TagDigest digest;
+        digest.update(tags);
+        REQUIRE(digest.describes(tags));
+        CHECK(std::string{digest.get(TagKey::highway)} == "primary");
+        CHECK(std::string{digest.get(TagKey::turn_lanes)} == "left|through");
+        CHECK(digest.get(TagKey::ref) == nullptr);
+        TagDigest::Scope scope {digest};
+        CHECK(std::string{TagDigest::value(tags, TagKey::name)} == "Hauptstraße");
+        CHECK(std::string{TagDigest::value(tags, "name")} == "Hauptstraße");
+        CHECK(std::string{TagDigest::value(tags, "fixme")} == "check");
+        CHECK(std::string{TagDigest::value(tags, TagKey::lanes, "")} == "");
+        CHECK(TagDigest::has_tag(tags, TagKey::highway, "primary"));
+        CHECK_FALSE(TagDigest::has_tag(tags, TagKey::highway, "secondary"));
+    }
+
+    SECTION("values without a digest") {
+        CHECK(std::string{TagDigest::value(tags, TagKey::highway)} == "primary");
+        CHECK(TagDigest::value(tags, TagKey::ref) == nullptr);
+        CHECK(std::string{TagDigest::value(tags, "fixme")} == "check");
+    }
+
+    SECTION("key mask") {
+        TagDigest digest;
+        digest.update(tags);
+        const key_mask_type keys = digest.key_mask();
+        CHECK(keys == (every_object | key_bit(TagKey::highway) | key_bit(TagKey::name)
+                | key_bit(TagKey::turn_lanes)));
+        CHECK((keys & key_bit(TagKey::place)) == 0);
+        // an untagged object only has the bit every_object
+        const size_t empty_offset = osmium::builder::add_way(buffer, _id(2));
+        digest.update(buffer.get<osmium::Way>(empty_offset).tags());
+        CHECK(digest.key_mask() == every_object);
+        CHECK(digest.get(TagKey::highway) == nullptr);
+    }
+
+    SECTION("store and restore") {
+        TagDigest digest;
+        digest.update(tags);
+        std::vector<const char*> values;
+        digest.store(values);
+        REQUIRE(values.size() == 3);
+        TagDigest restored;
+        restored.restore(tags, digest.key_mask(), values.data());
+        CHECK(restored.describes(tags));
+        CHECK(restored.key_mask() == digest.key_mask());
+        for (size_t i = 0; i < tag_digest_key_count; ++i) {
+            CHECK(restored.get(static_cast<TagKey>(i)) == digest.get(static_cast<TagKey>(i)));
+        }
+        // restoring an untagged object removes the previous values
+        const size_t empty_offset = osmium::builder::add_way(buffer, _id(2));
+        const osmium::TagList& empty_tags = buffer.get<osmium::Way>(empty_offset).tags();
+        restored.restore(empty_tags, every_object, nullptr);
+        CHECK(restored.key_mask() == every_object);
+        CHECK(restored.get(TagKey::highway) == nullptr);
+    }
+}
@@ -0,0 +1,64 @@
+/*
+ *  © 2026 Geofabrik GmbH
+ *
+ *  This file is part of osmi_simple_views.
+ *
+ *  osmi_simple_views is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  osmi_simple_views is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with osmi_simple_views. If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "catch.hpp"
+
+#include <string>
+
+#include <tag_string_builder.hpp>
+
+TEST_CASE("tag string builder") {
+    TagStringBuilder<32> builder;
+
+    SECTION("empty string") {
+        builder.reset();
+        CHECK(std::string{builder.finish()} == "");
+    }
+
+    SECTION("tags joined by the separator") {
+        builder.reset();
+        builder.append("highway", "primary", '|');
+        builder.append("ref", "B 1", '|');
+        CHECK(std::string{builder.finish()} == "highway=primary|ref=B 1");
+    }
+
+    SECTION("tags which do not fit are skipped") {
+        builder.reset();
+        builder.append("name", "Hauptstraße", ';');
+        builder.append("highway", "residential", ';');
+        builder.append("lit", "yes", ';');
+        CHECK(std::string{builder.finish()} == "name=Hauptstraße;lit=yes");
+    }
+
+    SECTION("long keys and values are skipped") {
+        TagStringBuilder<254> large_builder;
+        large_builder.reset();
+        large_builder.append("note", std::string(44, 'x').c_str(), '|');
+        large_builder.append("fixme", std::string(42, 'x').c_str(), '|');
+        CHECK(std::string{large_builder.finish()} == "fixme=" + std::string(42, 'x'));
+    }
+
+    SECTION("reset starts a new string") {
+        builder.reset();
+        builder.append("a", "b", '|');
+        builder.finish();
+        builder.reset();
+        builder.append("c", "d", '|');
+        CHECK(std::string{builder.finish()} == "c=d");
+    }
+}
@@ -0,0 +1,75 @@
+/*
+ *  © 2026 Geofabrik GmbH
+ *
+ *  This file is part of osmi_simple_views.
+ *
+ *  osmi_simple_views is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  osmi_simple_views is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with osmi_simple_views. If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "catch.hpp"
+
+#include <osmium/builder/attr.hpp>
+#include <osmium/memory/buffer.hpp>
+#include <osmium/osm/way.hpp>
+
+#include <way_batch.hpp>
+
+TEST_CASE("way batch") {
+    using namespace osmium::builder::attr;
+    osmium::memory::Buffer buffer {1024, osmium::memory::Buffer::auto_grow::yes};
+    osmium::builder::add_way(buffer, _id(1), _tag("highway", "primary"));
+    osmium::builder::add_way(buffer, _id(2), _tag("highway", "residential"));
+    osmium::builder::add_way(buffer, _id(3), _tag("highway", "track"));
+
+    WayBatch batch;
+    TagDigest digest;
+    for (const osmium::Way& way : buffer.select<osmium::Way>()) {
+        digest.update(way.tags());
+        batch.add(way, digest);
+    }
+    REQUIRE(batch.size() == 3);
+    CHECK(batch.key_mask(0) == (every_object | key_bit(TagKey::highway)));
+
+    SECTION("steps see the ways in order with their digests") {
+        std::vector<std::string> values;
+        batch.for_each([&values](const osmium::Way& way, const size_t index) {
+            CHECK(static_cast<size_t>(way.id()) == index + 1);
+            values.emplace_back(TagDigest::value(way.tags(), TagKey::highway));
+        });
+        const std::vector<std::string> expected {"primary", "residential", "track"};
+        CHECK(values == expected);
+    }
+
+    SECTION("ways are skipped after an invalid location") {
+        batch.for_each([](const osmium::Way& way, const size_t) {
+            if (way.id() == 2) {
+                throw osmium::invalid_location{"invalid location"};
+            }
+        });
+        CHECK(batch.failed(1));
+        CHECK_FALSE(batch.failed(0));
+        REQUIRE(batch.errors().size() == 1);
+        std::vector<osmium::object_id_type> ids;
+        batch.for_each([&ids](const osmium::Way& way, const size_t) {
+            ids.push_back(way.id());
+        });
+        const std::vector<osmium::object_id_type> expected {1, 3};
+        CHECK(ids == expected);
+    }
+
+    SECTION("clear") {
+        batch.clear();
+        CHECK(batch.empty());
+        CHECK(batch.errors().empty());
+    }
+}